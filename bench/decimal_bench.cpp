@@ -0,0 +1,887 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "decimal.hpp"
+
+namespace {
+
+constexpr std::size_t kValues = 1024;
+
+// std::is_signed does not know __int128 outside GNU mode.
+template <typename D>
+constexpr bool is_signed_decimal = D::min_fp != 0;
+
+template <typename D>
+constexpr int places_of() {
+    int n = 0;
+    for (auto s = D::scale; s > 1; s /= 10) {
+        ++n;
+    }
+    return n;
+}
+
+struct Rng {
+    uint64_t x = 88172645463325252ULL;
+    uint64_t operator()() {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return x;
+    }
+};
+
+/* ---- inputs ---- */
+
+// Raw fixed point values spread over the whole range, for formatting.
+template <typename D>
+std::vector<D> make_values() {
+    using IntType = typename D::IntType;
+    std::vector<D> values;
+    values.reserve(kValues);
+    Rng rng;
+    for (std::size_t i = 0; i < kValues; ++i) {
+        auto fp = static_cast<IntType>(rng() >> (1 + i % 48));
+        if constexpr (is_signed_decimal<D>) {
+            if (i % 2 == 1) {
+                fp = -fp;
+            }
+        }
+        values.emplace_back(fp);
+    }
+    return values;
+}
+
+// Values in [1, 10^k) with a full fraction, where k is half the integer digits, so that
+// any product or quotient of two of them stays in range.
+template <typename D>
+std::vector<D> make_operands() {
+    using IntType = typename D::IntType;
+    uint64_t int_mod = 1;
+    for (int i = 0; i < (D::digits - places_of<D>()) / 2; ++i) {
+        int_mod *= 10;
+    }
+
+    std::vector<D> values;
+    values.reserve(kValues);
+    Rng rng;
+    for (std::size_t i = 0; i < kValues; ++i) {
+        uint64_t units = int_mod > 1 ? 1 + rng() % (int_mod - 1) : 1;
+        auto fp = static_cast<IntType>(units * D::scale + rng() % D::scale);
+        if constexpr (is_signed_decimal<D>) {
+            if (i % 2 == 1) {
+                fp = -fp;
+            }
+        }
+        values.emplace_back(fp);
+    }
+    return values;
+}
+
+// Prices as they appear in a feed: up to five integer digits and up to eight places.
+template <typename D>
+std::vector<std::string> make_strings() {
+    constexpr int places = places_of<D>() < 8 ? places_of<D>() : 8;
+    uint64_t int_mod = 1;
+    for (int i = 0; i < 5 && i < D::digits - places_of<D>(); ++i) {
+        int_mod *= 10;
+    }
+
+    std::vector<std::string> strings;
+    Rng rng;
+    for (std::size_t i = 0; i < kValues; ++i) {
+        uint64_t x = rng();
+        std::string frac = std::to_string(x % 100000000);
+        frac = std::string(8 - frac.size(), '0') + frac;
+        std::string s = std::to_string((x >> 32) % int_mod) + "." + frac.substr(0, places);
+        if constexpr (is_signed_decimal<D>) {
+            if (i % 2 == 1) {
+                s = "-" + s;
+            }
+        }
+        strings.push_back(s);
+    }
+    return strings;
+}
+
+// The I8 operands as doubles, for the floating point baseline.
+std::vector<double> make_double_operands() {
+    std::vector<double> values;
+    for (const auto& d : make_operands<decimal::I8>()) {
+        values.push_back(d.to_double());
+    }
+    return values;
+}
+
+// Plain integers below 2^31, for the raw int64 baseline: the cost of the bare
+// instruction that any 64-bit fixed point type pays before checks and rounding.
+std::vector<int64_t> make_int_operands() {
+    std::vector<int64_t> values;
+    Rng rng;
+    for (std::size_t i = 0; i < kValues; ++i) {
+        auto v = static_cast<int64_t>(1 + (rng() >> 33));
+        values.push_back(i % 2 == 1 ? -v : v);
+    }
+    return values;
+}
+
+template <typename T>
+std::vector<T> make_operands_of() {
+    if constexpr (std::is_same_v<T, double>) {
+        return make_double_operands();
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return make_int_operands();
+    } else {
+        return make_operands<T>();
+    }
+}
+
+/* ---- construction ---- */
+
+template <typename D>
+void BM_FromString(benchmark::State& state) {
+    auto strings = make_strings<D>();
+    for (auto _ : state) {
+        for (const auto& s : strings) {
+            benchmark::DoNotOptimize(D(s));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_FromChars(benchmark::State& state) {
+    auto strings = make_strings<D>();
+    D out;
+    for (auto _ : state) {
+        for (const auto& s : strings) {
+            benchmark::DoNotOptimize(decimal::from_chars(s.data(), s.data() + s.size(), out));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ParseBatch(benchmark::State& state) {
+    auto strings = make_strings<D>();
+    std::vector<std::string_view> fields(strings.begin(), strings.end());
+    std::vector<D> out(fields.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(D::parse_batch(fields.data(), fields.data() + fields.size(), out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_FromDouble(benchmark::State& state) {
+    std::vector<double> doubles;
+    for (const auto& d : make_operands<D>()) {
+        doubles.push_back(d.to_double());
+    }
+    for (auto _ : state) {
+        for (double f : doubles) {
+            benchmark::DoNotOptimize(D(f));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_FromDoubles(benchmark::State& state) {
+    std::vector<double> doubles;
+    for (const auto& d : make_operands<D>()) {
+        doubles.push_back(d.to_double());
+    }
+    std::vector<D> out(kValues);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(D::from_doubles(doubles.data(), doubles.data() + doubles.size(), out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_FromInt(benchmark::State& state) {
+    std::vector<int> ints;
+    for (const auto& d : make_operands<D>()) {
+        ints.push_back(static_cast<int>(d.to_int()));
+    }
+    for (auto _ : state) {
+        for (int i : ints) {
+            benchmark::DoNotOptimize(D(i));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+void BM_StrtodBaseline(benchmark::State& state) {
+    auto strings = make_strings<decimal::I8>();
+    for (auto _ : state) {
+        for (const auto& s : strings) {
+            benchmark::DoNotOptimize(std::strtod(s.c_str(), nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+// The same digits with the point removed, through std::from_chars.
+void BM_Int64FromCharsBaseline(benchmark::State& state) {
+    auto strings = make_strings<decimal::I8>();
+    for (auto& s : strings) {
+        s.erase(s.find('.'), 1);
+    }
+    int64_t out;
+    for (auto _ : state) {
+        for (const auto& s : strings) {
+            benchmark::DoNotOptimize(std::from_chars(s.data(), s.data() + s.size(), out));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+/* ---- formatting ---- */
+
+// One digit per iteration with a branch for the point, as to_str() used to format.
+template <int nPlaces, decimal::Type S>
+char* naive_format(const decimal::Decimal<nPlaces, S>& d, char* end) {
+    auto val = d.fp;
+    if constexpr (S == decimal::Signed) {
+        if (d.fp < 0) {
+            val = -d.fp;
+        }
+    }
+
+    char* p = end - 1;
+    char* dec = p - nPlaces;
+    while (val >= 10 || p >= dec) {
+        *p-- = static_cast<char>(val % 10 + '0');
+        if (p == dec) {
+            *p-- = '.';
+        }
+        val /= 10;
+    }
+    *p = static_cast<char>(val + '0');
+
+    if constexpr (S == decimal::Signed) {
+        if (d.fp < 0) {
+            *--p = '-';
+        }
+    }
+    return p;
+}
+
+template <typename D>
+void BM_FormatNaive(benchmark::State& state) {
+    auto values = make_values<D>();
+    std::array<char, 32> buf;
+    for (auto _ : state) {
+        for (const auto& v : values) {
+            benchmark::DoNotOptimize(naive_format(v, buf.data() + buf.size()));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ToChars(benchmark::State& state) {
+    auto values = make_values<D>();
+    std::array<char, D::max_chars> buf;
+    for (auto _ : state) {
+        for (const auto& v : values) {
+            benchmark::DoNotOptimize(v.to_chars(buf.data(), buf.data() + buf.size(), 32));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ToString(benchmark::State& state) {
+    auto values = make_values<D>();
+    for (auto _ : state) {
+        for (const auto& v : values) {
+            benchmark::DoNotOptimize(v.to_string());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ToDouble(benchmark::State& state) {
+    auto values = make_operands<D>();
+    for (auto _ : state) {
+        for (const auto& v : values) {
+            benchmark::DoNotOptimize(v.to_double());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ToDoubles(benchmark::State& state) {
+    auto values = make_operands<D>();
+    std::vector<double> out(kValues);
+    for (auto _ : state) {
+        D::to_doubles(values.data(), values.data() + values.size(), out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+void BM_DoubleToCharsBaseline(benchmark::State& state) {
+    auto values = make_double_operands();
+    std::array<char, 32> buf;
+    for (auto _ : state) {
+        for (double v : values) {
+            benchmark::DoNotOptimize(std::to_chars(buf.data(), buf.data() + buf.size(), v));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+void BM_Int64ToCharsBaseline(benchmark::State& state) {
+    std::vector<int64_t> values;
+    for (const auto& d : make_values<decimal::I8>()) {
+        values.push_back(d.fp);
+    }
+    std::array<char, 32> buf;
+    for (auto _ : state) {
+        for (int64_t v : values) {
+            benchmark::DoNotOptimize(std::to_chars(buf.data(), buf.data() + buf.size(), v));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+/* ---- arithmetic ---- */
+
+struct Add {
+    template <typename T>
+    T operator()(const T& a, const T& b) const {
+        return a + b;
+    }
+};
+
+struct Sub {
+    template <typename T>
+    T operator()(const T& a, const T& b) const {
+        return a - b;
+    }
+};
+
+struct Mul {
+    template <typename T>
+    T operator()(const T& a, const T& b) const {
+        return a * b;
+    }
+};
+
+struct Div {
+    template <typename T>
+    T operator()(const T& a, const T& b) const {
+        return a / b;
+    }
+};
+
+// T is a Decimal, or double or int64_t as baselines. Unsigned operands are ordered so
+// that subtraction does not underflow.
+template <typename T, typename Op>
+void BM_Arith(benchmark::State& state) {
+    auto a = make_operands_of<T>();
+    auto b = make_operands_of<T>();
+    std::reverse(b.begin(), b.end());
+    if constexpr (std::is_same_v<Op, Sub> && !std::is_arithmetic_v<T>) {
+        if constexpr (!is_signed_decimal<T>) {
+            for (std::size_t i = 0; i < kValues; ++i) {
+                if (a[i] < b[i]) {
+                    std::swap(a[i], b[i]);
+                }
+            }
+        }
+    }
+    std::vector<T> out(kValues);
+    Op op;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            out[i] = op(a[i], b[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_BatchAdd(benchmark::State& state) {
+    auto a = make_operands<D>();
+    auto b = make_operands<D>();
+    std::vector<D> out(kValues);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decimal::batch::add(a.data(), b.data(), out.data(), kValues));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_BatchMulScalar(benchmark::State& state) {
+    auto a = make_operands<D>();
+    D k("1.25");
+    std::vector<D> out(kValues);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decimal::batch::mul_scalar(a.data(), k, out.data(), kValues));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+// Operands for Qty with their places cut to Price's, so that products still fit Qty.
+template <typename Price, typename Qty>
+std::vector<Price> make_prices() {
+    std::vector<Price> prices;
+    prices.reserve(kValues);
+    for (const auto& q : make_operands<Qty>()) {
+        prices.push_back(q.template convert_precision<places_of<Price>()>());
+    }
+    return prices;
+}
+
+// A price with Price's places times a quantity with Qty's, giving Qty's places: the
+// mixed precision operator against converting the price first.
+template <typename Price, typename Qty>
+void BM_MixedMul(benchmark::State& state) {
+    auto prices = make_prices<Price, Qty>();
+    auto qtys = make_operands<Qty>();
+    std::vector<Qty> out(kValues);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            out[i] = prices[i] * qtys[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename Price, typename Qty>
+void BM_MixedMulConvert(benchmark::State& state) {
+    auto prices = make_prices<Price, Qty>();
+    auto qtys = make_operands<Qty>();
+    std::vector<Qty> out(kValues);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            out[i] = prices[i].template convert_precision<places_of<Qty>()>() * qtys[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+// Summing a range with operator+=, which checks the range at every step, and with an
+// Accumulator, which checks it once.
+template <typename D>
+void BM_Sum(benchmark::State& state) {
+    auto values = make_operands<D>();
+    for (auto _ : state) {
+        D sum;
+        for (const auto& v : values) {
+            sum += v;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_AccumulatorSum(benchmark::State& state) {
+    auto values = make_operands<D>();
+    for (auto _ : state) {
+        typename D::Accumulator sum;
+        for (const auto& v : values) {
+            sum += v;
+        }
+        benchmark::DoNotOptimize(sum.value());
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ReduceSum(benchmark::State& state) {
+    auto values = make_operands<D>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decimal::reduce_sum(values.data(), kValues));
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ReduceMinMax(benchmark::State& state) {
+    auto values = make_operands<D>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decimal::reduce_minmax(values.data(), kValues));
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+// A shared running volume: Atomic's compare-and-swap loop against a mutex around +=.
+template <typename D>
+void BM_AtomicFetchAdd(benchmark::State& state) {
+    static decimal::Atomic<D> volume;
+    const D lot("0.01");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(volume.fetch_add(lot));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename D>
+void BM_MutexAdd(benchmark::State& state) {
+    static std::mutex mutex;
+    static D volume;
+    const D lot("0.01");
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        volume += lot;
+        benchmark::DoNotOptimize(volume);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Operands for D shrunk so that the sum of kValues products of them still fits.
+template <typename D>
+std::vector<D> make_positions() {
+    auto values = make_operands<D>();
+    for (auto& v : values) {
+        v.fp /= 10000;
+    }
+    return values;
+}
+
+// Notional of a book of positions: a dot product against a loop of operator* and +=,
+// which truncates and range-checks every product.
+template <typename Price, typename Qty>
+void BM_Dot(benchmark::State& state) {
+    auto prices = make_prices<Price, Qty>();
+    auto qtys = make_positions<Qty>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decimal::dot(prices.data(), qtys.data(), kValues));
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename Price, typename Qty>
+void BM_DotLoop(benchmark::State& state) {
+    auto prices = make_prices<Price, Qty>();
+    auto qtys = make_positions<Qty>();
+    for (auto _ : state) {
+        Qty sum;
+        for (std::size_t i = 0; i < kValues; ++i) {
+            sum += prices[i] * qtys[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_Round(benchmark::State& state) {
+    auto a = make_operands<D>();
+    std::vector<D> out(kValues);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            out[i] = a[i].round(static_cast<int>(i % places_of<D>()));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_ConvertPrecisionDown(benchmark::State& state) {
+    using To = decltype(std::declval<D>().template convert_precision<places_of<D>() / 2>());
+    auto a = make_operands<D>();
+    std::vector<To> out(kValues);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            out[i] = a[i].template convert_precision<places_of<D>() / 2>();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+/* ---- encoding ---- */
+
+// Encoded values are kept within [min_fp, max_fp], which decoding checks.
+template <typename D>
+std::vector<D> make_encodable() {
+    auto values = make_values<D>();
+    for (auto& v : values) {
+        if (v.fp > D::max_fp || v.fp < D::min_fp) {
+            v.fp /= 16;
+        }
+    }
+    return values;
+}
+
+template <typename D>
+void BM_EncodeBinary(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf(kValues * 12);
+    for (auto _ : state) {
+        std::size_t offset = 0;
+        for (const auto& v : values) {
+            v.encode_binary(buf, offset);
+        }
+        benchmark::DoNotOptimize(buf.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_EncodeBytes(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf(kValues * D::max_encoded_size);
+    for (auto _ : state) {
+        uint8_t* p = buf.data();
+        for (const auto& v : values) {
+            p += v.encode_binary(p);
+        }
+        benchmark::DoNotOptimize(p);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_EncodeBatch(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf(kValues * D::max_encoded_size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(D::encode_binary_batch(values.data(), values.data() + values.size(), buf.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_DecodeBinary(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf;
+    std::size_t offset = 0;
+    for (const auto& v : values) {
+        v.encode_binary(buf, offset);
+    }
+    D out;
+    for (auto _ : state) {
+        offset = 0;
+        for (std::size_t i = 0; i < kValues; ++i) {
+            out.decode_binary(buf, offset);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_DecodeBytes(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf;
+    std::size_t offset = 0;
+    for (const auto& v : values) {
+        v.encode_binary(buf, offset);
+    }
+    for (auto _ : state) {
+        const uint8_t* p = buf.data();
+        const uint8_t* end = p + buf.size();
+        for (std::size_t i = 0; i < kValues; ++i) {
+            auto res = D::decode_binary(p, static_cast<std::size_t>(end - p));
+            benchmark::DoNotOptimize(res.value);
+            p += res.size;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename D>
+void BM_DecodeBatch(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf(kValues * D::max_encoded_size);
+    buf.resize(D::encode_binary_batch(values.data(), values.data() + values.size(), buf.data()));
+    std::vector<D> out(kValues);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(D::decode_binary_batch(buf.data(), buf.size(), out.data(), out.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+    state.SetBytesProcessed(state.iterations() * buf.size());
+}
+
+template <typename D>
+void BM_DecodeStream(benchmark::State& state) {
+    auto values = make_encodable<D>();
+    std::vector<uint8_t> buf(kValues * D::max_encoded_size + 1);
+    buf.resize(D::encode_binary_stream(values.data(), values.data() + values.size(), buf.data()));
+    std::vector<D> out(kValues);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(D::decode_binary_stream(buf.data(), buf.size(), out.data(), out.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+    state.SetBytesProcessed(state.iterations() * buf.size());
+}
+
+/* ---- workloads ---- */
+
+// A typical pricing step: notional, fee, average price and a rounded quote.
+template <typename D>
+void BM_PricingLoop(benchmark::State& state) {
+    auto prices = make_strings<D>();
+    std::vector<D> px(kValues), qty(kValues), out(kValues);
+    for (std::size_t i = 0; i < kValues; ++i) {
+        px[i] = D(prices[i]);
+        qty[i] = D(static_cast<int>(1 + i % 500));
+    }
+    D fee("0.0004");
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            D notional = px[i] * qty[i];
+            D net = notional + notional * fee;
+            out[i] = (net / qty[i]).round(2);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+void BM_PricingLoopDoubleBaseline(benchmark::State& state) {
+    auto prices = make_strings<decimal::I8>();
+    std::vector<double> px(kValues), qty(kValues), out(kValues);
+    for (std::size_t i = 0; i < kValues; ++i) {
+        px[i] = std::strtod(prices[i].c_str(), nullptr);
+        qty[i] = static_cast<double>(1 + i % 500);
+    }
+    double fee = 0.0004;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kValues; ++i) {
+            double notional = px[i] * qty[i];
+            double net = notional + notional * fee;
+            out[i] = std::round(net / qty[i] * 100) / 100;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+}  // namespace
+
+#define DECIMAL_BENCH_TYPES(BM)              \
+    BENCHMARK_TEMPLATE(BM, decimal::U1);     \
+    BENCHMARK_TEMPLATE(BM, decimal::U2);     \
+    BENCHMARK_TEMPLATE(BM, decimal::U4);     \
+    BENCHMARK_TEMPLATE(BM, decimal::U8);     \
+    BENCHMARK_TEMPLATE(BM, decimal::U12);    \
+    BENCHMARK_TEMPLATE(BM, decimal::U18);    \
+    BENCHMARK_TEMPLATE(BM, decimal::I1);     \
+    BENCHMARK_TEMPLATE(BM, decimal::I2);     \
+    BENCHMARK_TEMPLATE(BM, decimal::I4);     \
+    BENCHMARK_TEMPLATE(BM, decimal::I8);     \
+    BENCHMARK_TEMPLATE(BM, decimal::I12);    \
+    BENCHMARK_TEMPLATE(BM, decimal::I17)
+
+// Arithmetic needs room for integer digits on both sides of a product.
+#define DECIMAL_BENCH_ARITH_TYPES(BM, ...)                \
+    BENCHMARK_TEMPLATE(BM, decimal::U2, ##__VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(BM, decimal::U4, ##__VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(BM, decimal::U8, ##__VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(BM, decimal::U12, ##__VA_ARGS__);  \
+    BENCHMARK_TEMPLATE(BM, decimal::I2, ##__VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(BM, decimal::I4, ##__VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(BM, decimal::I8, ##__VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(BM, decimal::I12, ##__VA_ARGS__)
+
+// 128-bit Decimals, for comparison with the 64-bit types of the same places.
+#define DECIMAL_BENCH_WIDE_TYPES(BM, ...)                                           \
+    BENCHMARK_TEMPLATE(BM, decimal::Decimal<8, decimal::WideSigned>, ##__VA_ARGS__); \
+    BENCHMARK_TEMPLATE(BM, decimal::Decimal<18, decimal::WideSigned>, ##__VA_ARGS__)
+
+#define DECIMAL_BENCH_OP(Op)                         \
+    DECIMAL_BENCH_ARITH_TYPES(BM_Arith, Op);         \
+    DECIMAL_BENCH_WIDE_TYPES(BM_Arith, Op);          \
+    BENCHMARK_TEMPLATE(BM_Arith, double, Op);        \
+    BENCHMARK_TEMPLATE(BM_Arith, int64_t, Op)
+
+DECIMAL_BENCH_ARITH_TYPES(BM_FromString);
+DECIMAL_BENCH_WIDE_TYPES(BM_FromString);
+DECIMAL_BENCH_TYPES(BM_FromChars);
+DECIMAL_BENCH_TYPES(BM_ParseBatch);
+DECIMAL_BENCH_ARITH_TYPES(BM_FromDouble);
+DECIMAL_BENCH_ARITH_TYPES(BM_FromDoubles);
+DECIMAL_BENCH_ARITH_TYPES(BM_FromInt);
+BENCHMARK(BM_StrtodBaseline);
+BENCHMARK(BM_Int64FromCharsBaseline);
+
+DECIMAL_BENCH_TYPES(BM_FormatNaive);
+DECIMAL_BENCH_TYPES(BM_ToChars);
+DECIMAL_BENCH_ARITH_TYPES(BM_ToString);
+DECIMAL_BENCH_WIDE_TYPES(BM_ToString);
+DECIMAL_BENCH_ARITH_TYPES(BM_ToDouble);
+DECIMAL_BENCH_ARITH_TYPES(BM_ToDoubles);
+BENCHMARK(BM_DoubleToCharsBaseline);
+BENCHMARK(BM_Int64ToCharsBaseline);
+
+DECIMAL_BENCH_OP(Add);
+DECIMAL_BENCH_OP(Sub);
+DECIMAL_BENCH_OP(Mul);
+DECIMAL_BENCH_OP(Div);
+DECIMAL_BENCH_ARITH_TYPES(BM_BatchAdd);
+DECIMAL_BENCH_ARITH_TYPES(BM_BatchMulScalar);
+BENCHMARK_TEMPLATE(BM_MixedMul, decimal::U2, decimal::U8);
+BENCHMARK_TEMPLATE(BM_MixedMulConvert, decimal::U2, decimal::U8);
+BENCHMARK_TEMPLATE(BM_MixedMul, decimal::I2, decimal::I8);
+BENCHMARK_TEMPLATE(BM_MixedMulConvert, decimal::I2, decimal::I8);
+DECIMAL_BENCH_ARITH_TYPES(BM_Sum);
+DECIMAL_BENCH_ARITH_TYPES(BM_AccumulatorSum);
+DECIMAL_BENCH_WIDE_TYPES(BM_Sum);
+DECIMAL_BENCH_WIDE_TYPES(BM_AccumulatorSum);
+DECIMAL_BENCH_ARITH_TYPES(BM_ReduceSum);
+DECIMAL_BENCH_ARITH_TYPES(BM_ReduceMinMax);
+BENCHMARK_TEMPLATE(BM_AtomicFetchAdd, decimal::U8)->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(BM_MutexAdd, decimal::U8)->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(BM_Dot, decimal::I2, decimal::I8);
+BENCHMARK_TEMPLATE(BM_DotLoop, decimal::I2, decimal::I8);
+BENCHMARK_TEMPLATE(BM_Dot, decimal::I8, decimal::I8);
+BENCHMARK_TEMPLATE(BM_DotLoop, decimal::I8, decimal::I8);
+DECIMAL_BENCH_ARITH_TYPES(BM_Round);
+DECIMAL_BENCH_ARITH_TYPES(BM_ConvertPrecisionDown);
+
+DECIMAL_BENCH_TYPES(BM_EncodeBinary);
+DECIMAL_BENCH_TYPES(BM_EncodeBytes);
+DECIMAL_BENCH_TYPES(BM_EncodeBatch);
+DECIMAL_BENCH_TYPES(BM_DecodeBinary);
+DECIMAL_BENCH_TYPES(BM_DecodeBytes);
+DECIMAL_BENCH_TYPES(BM_DecodeBatch);
+DECIMAL_BENCH_TYPES(BM_DecodeStream);
+
+BENCHMARK_TEMPLATE(BM_PricingLoop, decimal::U4);
+BENCHMARK_TEMPLATE(BM_PricingLoop, decimal::U8);
+BENCHMARK_TEMPLATE(BM_PricingLoop, decimal::I4);
+BENCHMARK_TEMPLATE(BM_PricingLoop, decimal::I8);
+BENCHMARK(BM_PricingLoopDoubleBaseline);
+
+BENCHMARK_MAIN();
@@ -3,19 +3,43 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <charconv>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <cwchar>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX2__) || defined(__AVX512F__) || defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // The decimal namespace provides functionalities for handling decimal arithmetic with
 // variable precision. It includes templates for signed and unsigned decimal types.
 namespace decimal {
@@ -30,7 +54,26 @@ namespace decimal {
 
 enum Type {
     Signed,
-    Unsigned
+    Unsigned,
+    WideSigned,   // backed by __int128, 38 digits
+    WideUnsigned  // backed by unsigned __int128, 38 digits
+};
+
+// Rounding selects how a result that falls between two representable values is resolved.
+enum class Rounding {
+    Truncate,  // toward zero
+    HalfUp,    // to nearest, ties away from zero
+    HalfEven,  // to nearest, ties to even
+    Floor,     // toward negative infinity
+    Ceil       // toward positive infinity
+};
+
+// Overflow selects what arithmetic does when a result falls outside [min_fp, max_fp].
+enum class Overflow {
+    Throw,     // throw std::overflow_error
+    Saturate,  // clamp to min_fp or max_fp
+    Wrap,      // keep the exact result modulo 2^(bits of IntType): 2^64, or 2^128 when wide
+    Unchecked  // skip the checks; an out of range result is unspecified
 };
 
 namespace detail {
@@ -42,11 +85,23 @@ struct has_int128_impl<T, std::void_t<decltype(T(1) * T(1))>> : std::true_type {
 
 constexpr bool has_int128 = has_int128_impl<__int128>::value;
 
-template <int base, int exponent>
-constexpr uint64_t const_pow() {
+// is_constant_evaluated is std::is_constant_evaluated, which GCC and Clang also offer
+// before C++20, so code using intrinsics can fall back to plain arithmetic at compile time.
+constexpr bool is_constant_evaluated() {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+template <int base, int exponent, typename T = uint64_t>
+constexpr T const_pow() {
     static_assert(base > 0, "Base must be positive");
     static_assert(exponent >= 0, "Exponent cannot be negative");
-    uint64_t result = 1;
+    T result = 1;
     for (int i = 0; i < exponent; ++i) {
         result *= base;
     }
@@ -56,92 +111,1067 @@ constexpr uint64_t const_pow() {
 template <Type T>
 struct IntTypeMap;
 
+// IntTypeMap gives the backing integer of a Type, its unsigned counterpart and how many
+// decimal digits it always holds. std::numeric_limits is not used as it only knows about
+// __int128 in GNU mode.
 template <>
 struct IntTypeMap<Signed> {
     using type = int64_t;
+    using utype = uint64_t;
+    static constexpr int digits10 = 18;
 };
 
 template <>
 struct IntTypeMap<Unsigned> {
     using type = uint64_t;
+    using utype = uint64_t;
+    static constexpr int digits10 = 19;
+};
+
+template <>
+struct IntTypeMap<WideSigned> {
+    using type = __int128;
+    using utype = unsigned __int128;
+    static constexpr int digits10 = 38;
+};
+
+template <>
+struct IntTypeMap<WideUnsigned> {
+    using type = unsigned __int128;
+    using utype = unsigned __int128;
+    static constexpr int digits10 = 38;
+};
+
+constexpr bool is_signed(Type t) { return t == Signed || t == WideSigned; }
+
+// round_quotient rounds the quotient q of a division by d according to R, given the
+// remainder and whether the value is negative.
+template <Rounding R, typename U>
+constexpr U round_quotient(U q, U rem, U d, bool neg) {
+    bool up = false;
+    if constexpr (R == Rounding::HalfUp) {
+        up = rem >= d - d / 2;
+    } else if constexpr (R == Rounding::HalfEven) {
+        up = rem > d / 2 || (d % 2 == 0 && rem == d / 2 && (q & 1) != 0);
+    } else if constexpr (R == Rounding::Floor) {
+        up = neg && rem != 0;
+    } else if constexpr (R == Rounding::Ceil) {
+        up = !neg && rem != 0;
+    }
+    return q + (up ? 1 : 0);
+}
+
+// div_round returns m / d rounded according to R, where m is the magnitude of a value
+// that is negative when neg is set.
+template <Rounding R, typename U>
+constexpr U div_round(U m, U d, bool neg) {
+    U q = m / d;
+    return round_quotient<R>(q, m - q * d, d, neg);
+}
+
+// Reciprocal holds what div_wide needs to divide by the constant d: the shift that sets
+// its top bit and floor((2^128 - 1) / normalised d) - 2^64.
+template <uint64_t d>
+struct Reciprocal {
+    static_assert(d != 0);
+    static constexpr int shift = [] {
+        int n = 0;
+        while ((d << n) >> 63 == 0) {
+            ++n;
+        }
+        return n;
+    }();
+    static constexpr uint64_t norm = d << shift;
+    static constexpr uint64_t value = static_cast<uint64_t>(~static_cast<unsigned __int128>(0) / norm);
+};
+
+// div_wide returns x / d and stores the remainder in rem, for a quotient that fits in
+// 64 bits (x < d * 2^64). It is the 2/1 division with a precomputed reciprocal of Möller
+// and Granlund, two multiplies in place of the __udivti3 call a plain division makes.
+template <uint64_t d>
+constexpr uint64_t div_wide(unsigned __int128 x, uint64_t& rem) {
+    using R = Reciprocal<d>;
+    x <<= R::shift;
+    auto u1 = static_cast<uint64_t>(x >> 64);
+    auto u0 = static_cast<uint64_t>(x);
+
+    unsigned __int128 q = static_cast<unsigned __int128>(R::value) * u1 + x;
+    auto q1 = static_cast<uint64_t>(q >> 64) + 1;
+    auto q0 = static_cast<uint64_t>(q);
+    uint64_t r = u0 - q1 * R::norm;
+    // This adjustment is taken about half the time, so it is done without a branch.
+    uint64_t mask = 0 - static_cast<uint64_t>(r > q0);
+    q1 += mask;
+    r += mask & R::norm;
+    if (unlikely(r >= R::norm)) {
+        ++q1;
+        r -= R::norm;
+    }
+    rem = r >> R::shift;
+    return q1;
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DECIMAL_DIVQ 1
+
+inline uint64_t divq(unsigned __int128 x, uint64_t d, uint64_t& rem) {
+    uint64_t q;
+    __asm__("divq %[d]" : "=a"(q), "=d"(rem) : [d] "rm"(d), "a"(static_cast<uint64_t>(x)), "d"(static_cast<uint64_t>(x >> 64)));
+    return q;
+}
+#endif
+
+// div_128 returns x / d and stores the remainder in rem for a runtime divisor d, where
+// the quotient fits in 64 bits (x < d * 2^64). On x86-64 that is a single divq rather
+// than a call to __udivti3.
+constexpr uint64_t div_128(unsigned __int128 x, uint64_t d, uint64_t& rem) {
+#ifdef DECIMAL_DIVQ
+    if (!is_constant_evaluated()) {
+        return divq(x, d, rem);
+    }
+#endif
+    auto q = static_cast<uint64_t>(x / d);
+    rem = static_cast<uint64_t>(x) - q * d;
+    return q;
+}
+
+// mul_256 stores the 256-bit product a * b as hi * 2^128 + lo.
+constexpr void mul_256(unsigned __int128 a, unsigned __int128 b, unsigned __int128& hi, unsigned __int128& lo) {
+    using u128 = unsigned __int128;
+    auto a0 = static_cast<uint64_t>(a), a1 = static_cast<uint64_t>(a >> 64);
+    auto b0 = static_cast<uint64_t>(b), b1 = static_cast<uint64_t>(b >> 64);
+
+    u128 p00 = static_cast<u128>(a0) * b0;
+    u128 p01 = static_cast<u128>(a0) * b1;
+    u128 p10 = static_cast<u128>(a1) * b0;
+    u128 p11 = static_cast<u128>(a1) * b1;
+    u128 mid = (p00 >> 64) + static_cast<uint64_t>(p01) + static_cast<uint64_t>(p10);
+    lo = (mid << 64) | static_cast<uint64_t>(p00);
+    hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+// div_3by2 divides r * 2^64 + u by v, whose top bit is set, for r < v. It returns the
+// 64-bit quotient and leaves the remainder in r (one step of Knuth's algorithm D).
+constexpr uint64_t div_3by2(unsigned __int128& r, uint64_t u, unsigned __int128 v) {
+    using u128 = unsigned __int128;
+    auto v1 = static_cast<uint64_t>(v >> 64), v0 = static_cast<uint64_t>(v);
+
+    // Estimate from the top limbs, then correct it so it is at most one too large.
+    uint64_t q = 0;
+    u128 rhat = 0;
+    if (static_cast<uint64_t>(r >> 64) >= v1) {
+        q = ~uint64_t(0);
+        rhat = static_cast<u128>(static_cast<uint64_t>(r)) + v1;
+    } else {
+        uint64_t rem = 0;
+        q = div_128(r, v1, rem);
+        rhat = rem;
+    }
+    while ((rhat >> 64) == 0 && static_cast<u128>(q) * v0 > ((rhat << 64) | u)) {
+        --q;
+        rhat += v1;
+    }
+
+    // r * 2^64 + u - q * v as 192 bits, adding v back if q was one too large.
+    u128 p0 = static_cast<u128>(q) * v0;
+    u128 p1 = static_cast<u128>(q) * v1 + (p0 >> 64);
+    auto p0_lo = static_cast<uint64_t>(p0);
+    uint64_t borrow = u < p0_lo ? 1 : 0;
+    uint64_t low = u - p0_lo;
+    bool negative = r < p1 || r - p1 < borrow;
+    u128 high = r - p1 - borrow;
+    if (negative) {
+        --q;
+        uint64_t sum = low + v0;
+        high += static_cast<u128>(v1) + (sum < low ? 1 : 0);
+        low = sum;
+    }
+    r = (high << 64) | low;
+    return q;
+}
+
+// div_256 returns (hi * 2^128 + lo) / d and stores the remainder in rem, where the
+// quotient fits in 128 bits (hi < d).
+constexpr unsigned __int128 div_256(unsigned __int128 hi, unsigned __int128 lo, unsigned __int128 d, unsigned __int128& rem) {
+    using u128 = unsigned __int128;
+    if ((d >> 64) == 0) {
+        // Long division by a single limb, as hi < d every step fits divq.
+        uint64_t r = 0;
+        uint64_t q1 = div_128((hi << 64) | static_cast<uint64_t>(lo >> 64), static_cast<uint64_t>(d), r);
+        uint64_t q0 = div_128((static_cast<u128>(r) << 64) | static_cast<uint64_t>(lo), static_cast<uint64_t>(d), r);
+        rem = r;
+        return (static_cast<u128>(q1) << 64) | q0;
+    }
+
+    int shift = __builtin_clzll(static_cast<uint64_t>(d >> 64));
+    u128 v = d << shift;
+    u128 r = shift == 0 ? hi : (hi << shift) | (lo >> (128 - shift));
+    u128 n = lo << shift;
+    uint64_t q1 = div_3by2(r, static_cast<uint64_t>(n >> 64), v);
+    uint64_t q0 = div_3by2(r, static_cast<uint64_t>(n), v);
+    rem = r >> shift;
+    return (static_cast<u128>(q1) << 64) | q0;
+}
+
+// div_256_64 divides hi * 2^128 + lo by d in place, one 64-bit limb at a time, and
+// returns the remainder.
+constexpr uint64_t div_256_64(unsigned __int128& hi, unsigned __int128& lo, uint64_t d) {
+    using u128 = unsigned __int128;
+    uint64_t limbs[4] = {static_cast<uint64_t>(hi >> 64), static_cast<uint64_t>(hi), static_cast<uint64_t>(lo >> 64),
+                         static_cast<uint64_t>(lo)};
+    uint64_t r = 0;
+    for (uint64_t& limb : limbs) {
+        limb = div_128((static_cast<u128>(r) << 64) | limb, d, r);
+    }
+    hi = (static_cast<u128>(limbs[0]) << 64) | limbs[1];
+    lo = (static_cast<u128>(limbs[2]) << 64) | limbs[3];
+    return r;
+}
+
+// Pow10Divisor divides any 64-bit x by a power of ten with a multiply-high and shifts,
+// t = mulhi(x, magic), q = (t + ((x - t) >> 1)) >> shift (Granlund and Montgomery).
+struct Pow10Divisor {
+    uint64_t magic;
+    int shift;
 };
 
+constexpr Pow10Divisor make_pow10_divisor(unsigned int n) {
+    unsigned __int128 d = 1;
+    for (unsigned int i = 0; i < n; ++i) {
+        d *= 10;
+    }
+    int l = 0;
+    while ((static_cast<unsigned __int128>(1) << l) < d) {
+        ++l;
+    }
+    auto magic = ((((static_cast<unsigned __int128>(1) << l) - d) << 64) / d) + 1;
+    return {static_cast<uint64_t>(magic), l - 1};
+}
+
+template <std::size_t... n>
+constexpr std::array<Pow10Divisor, sizeof...(n)> make_pow10_divisors(std::index_sequence<n...>) {
+    return {make_pow10_divisor(n)...};
+}
+
+// pow10_divisors[n] divides by 10^n, for n in [1, 19].
+inline constexpr auto pow10_divisors = make_pow10_divisors(std::make_index_sequence<20>{});
+
+// div_pow10 returns x / 10^n for n in [1, 19] without a hardware divide.
+constexpr uint64_t div_pow10(uint64_t x, unsigned int n) {
+    const Pow10Divisor& d = pow10_divisors[n];
+    auto t = static_cast<uint64_t>((static_cast<unsigned __int128>(x) * d.magic) >> 64);
+    return (t + ((x - t) >> 1)) >> d.shift;
+}
+
+constexpr bool is_digit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DECIMAL_FIXED_PARSE 1
+
+// load_right_aligned returns the n <= 8 bytes at p in the top lanes of a little endian
+// word, padded with '0' in front. It never reads outside [p, p + n) and builds the word
+// in a register so the vector code that follows does not stall on store forwarding.
+inline uint64_t load_right_aligned(const char* p, std::size_t n) {
+    uint64_t w = 0;
+    if (n == 8) {
+        std::memcpy(&w, p, 8);
+        return w;
+    }
+    if (n >= 4) {
+        uint32_t head, tail;
+        std::memcpy(&head, p, 4);
+        std::memcpy(&tail, p + n - 4, 4);
+        w = (static_cast<uint64_t>(tail) << 32) | (static_cast<uint64_t>(head) << (8 * (8 - n)));
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            w |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * (8 - n + i));
+        }
+    }
+    return w | (0x3030303030303030ULL >> (8 * n));
+}
+
+// parse_fixed_digits converts the n <= 16 characters at p, which must all be digits
+// except for at most one point, into value along with the number of digits either side
+// of the point. It returns false for anything else.
+inline bool parse_fixed_digits(const char* p, std::size_t n, uint64_t& value, std::size_t& int_len,
+                               std::size_t& frac_len) {
+    // The characters right aligned in a 16 lane block, lead holding lanes 0-7.
+    uint64_t lead = 0x3030303030303030ULL, trail = 0;
+    if (n > 8) {
+        std::memcpy(&trail, p + n - 8, 8);
+        lead = load_right_aligned(p, n - 8);
+    } else {
+        trail = load_right_aligned(p, n);
+    }
+
+#if defined(__SSE4_1__)
+    __m128i chars = _mm_set_epi64x(static_cast<int64_t>(trail), static_cast<int64_t>(lead));
+    auto points = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('.'))));
+    if (unlikely((points & (points - 1)) != 0)) {
+        return false;
+    }
+    int point = points != 0 ? __builtin_ctz(points) : -1;
+
+    // Drop the point by moving every lane before it up one, shifting a zero in at the front.
+    __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i shuffle = _mm_add_epi8(iota, _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(point + 1)), iota));
+    __m128i digits = _mm_shuffle_epi8(_mm_sub_epi8(chars, _mm_set1_epi8('0')), shuffle);
+
+    __m128i nines = _mm_min_epu8(digits, _mm_set1_epi8(9));
+    if (unlikely(_mm_movemask_epi8(_mm_cmpeq_epi8(nines, digits)) != 0xFFFF)) {
+        return false;
+    }
+
+    // Combine neighbouring lanes into 2, 4 and then 8 digit values.
+    __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    quads = _mm_packus_epi32(quads, quads);
+    __m128i octets = _mm_madd_epi16(quads, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+    auto hi = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    auto lo = static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+    value = static_cast<uint64_t>(hi) * 100000000 + lo;
+#else
+    // SWAR: find the point with the zero byte trick, whose lowest flag is exact.
+    auto points = [](uint64_t w) {
+        uint64_t x = w ^ 0x2E2E2E2E2E2E2E2EULL;
+        return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+    };
+    uint64_t lead_points = points(lead), trail_points = points(trail);
+    int point = lead_points != 0 ? __builtin_ctzll(lead_points) / 8 : trail_points != 0 ? 8 + __builtin_ctzll(trail_points) / 8 : -1;
+    if (point >= 0) {
+        // Drop the point by moving every lane before it up one. A second point is left in
+        // place and rejected below.
+        auto drop = [](uint64_t w, int lane, uint64_t carry) {
+            uint64_t before = w & ((1ULL << (8 * lane)) - 1);
+            uint64_t after = lane == 7 ? 0 : w >> (8 * (lane + 1)) << (8 * (lane + 1));
+            return after | (before << 8) | carry;
+        };
+        if (point < 8) {
+            lead = drop(lead, point, '0');
+        } else {
+            trail = drop(trail, point - 8, lead >> 56);
+            lead = (lead << 8) | '0';
+        }
+    }
+
+    // Validate and convert eight digits per word.
+    auto eight = [](uint64_t w, uint64_t& v) {
+        if (unlikely((((w & 0xF0F0F0F0F0F0F0F0) | (((w + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))) !=
+                     0x3333333333333333)) {
+            return false;
+        }
+        w -= 0x3030303030303030;
+        w = (w * 10) + (w >> 8);
+        v = (((w & 0x000000FF000000FF) * 0x000F424000000064) + (((w >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >> 32;
+        return true;
+    };
+
+    uint64_t hi = 0, lo = 0;
+    if (!eight(lead, hi) || !eight(trail, lo)) {
+        return false;
+    }
+    value = hi * 100000000 + lo;
+#endif
+
+    frac_len = point >= 0 ? static_cast<std::size_t>(15 - point) : 0;
+    int_len = n - frac_len - (point >= 0 ? 1 : 0);
+    return true;
+}
+#endif
+
+// Two ASCII digits for every value in [0, 100), used to format two digits at a time.
+inline constexpr char digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// write_digits writes exactly n digits of val backwards ending at end.
+template <typename T>
+inline char* write_digits(char* end, T val, int n) {
+    for (; n >= 2; n -= 2) {
+        end -= 2;
+        std::memcpy(end, &digit_pairs[(val % 100) * 2], 2);
+        val /= 100;
+    }
+    if (n != 0) {
+        *--end = static_cast<char>(val % 10 + '0');
+    }
+    return end;
+}
+
+// write_digits writes all the digits of val, at least one, backwards ending at end.
+// Values that fit in 32 bits finish with cheaper 32-bit arithmetic.
+inline char* write_digits(char* end, uint64_t val) {
+    while (val > std::numeric_limits<uint32_t>::max()) {
+        end -= 2;
+        std::memcpy(end, &digit_pairs[(val % 100) * 2], 2);
+        val /= 100;
+    }
+
+    auto v = static_cast<uint32_t>(val);
+    while (v >= 100) {
+        end -= 2;
+        std::memcpy(end, &digit_pairs[(v % 100) * 2], 2);
+        v /= 100;
+    }
+    if (v >= 10) {
+        end -= 2;
+        std::memcpy(end, &digit_pairs[v * 2], 2);
+    } else {
+        *--end = static_cast<char>(v + '0');
+    }
+    return end;
+}
+
+// Every power of ten that fits in uint64_t and int64_t, for precomputed_pow_10.
+inline constexpr std::array<uint64_t, 20> unsigned_powers_of_10 = {1,
+                                                                   10,
+                                                                   100,
+                                                                   1000,
+                                                                   10000,
+                                                                   100000,
+                                                                   1000000,
+                                                                   10000000,
+                                                                   100000000,
+                                                                   1000000000,
+                                                                   10000000000,
+                                                                   100000000000,
+                                                                   1000000000000,
+                                                                   10000000000000,
+                                                                   100000000000000,
+                                                                   1000000000000000,
+                                                                   10000000000000000,
+                                                                   100000000000000000,
+                                                                   1000000000000000000,
+                                                                   10000000000000000000UL};
+
+inline constexpr std::array<int64_t, 19> signed_powers_of_10 = {1,
+                                                                10,
+                                                                100,
+                                                                1000,
+                                                                10000,
+                                                                100000,
+                                                                1000000,
+                                                                10000000,
+                                                                100000000,
+                                                                1000000000,
+                                                                10000000000,
+                                                                100000000000,
+                                                                1000000000000,
+                                                                10000000000000,
+                                                                100000000000000,
+                                                                1000000000000000,
+                                                                10000000000000000,
+                                                                100000000000000000,
+                                                                1000000000000000000};
+
+// write_digits writes exactly n digits of a 128-bit val, 19 at a time.
+inline char* write_digits(char* end, unsigned __int128 val, int n) {
+    constexpr uint64_t chunk = 10000000000000000000ULL;
+    for (; n > 19; n -= 19) {
+        end = write_digits(end, static_cast<uint64_t>(val % chunk), 19);
+        val /= chunk;
+    }
+    return write_digits(end, static_cast<uint64_t>(val), n);
+}
+
+// write_digits writes all the digits of a 128-bit val.
+inline char* write_digits(char* end, unsigned __int128 val) {
+    constexpr uint64_t chunk = 10000000000000000000ULL;
+    while (val > std::numeric_limits<uint64_t>::max()) {
+        end = write_digits(end, static_cast<uint64_t>(val % chunk), 19);
+        val /= chunk;
+    }
+    return write_digits(end, static_cast<uint64_t>(val));
+}
+
+// encode_binary writes each value as a little endian base 128 varint followed by a header
+// byte with the number of places in its low 6 bits and the format above them. Unsigned
+// types write the plain value, signed types its ZigZag mapping. Formats 2 and 3 are reserved.
+constexpr int kBinaryFormatShift = 6;
+constexpr uint8_t kBinaryPlacesMask = 0x3F;
+constexpr uint8_t kBinaryPlain = 0;
+constexpr uint8_t kBinaryZigZag = 1;
+
+// write_varint writes v as a little endian base 128 varint at p and returns its end. All
+// ten bytes a varint can take are written whatever its length, without branches, so p
+// needs room for 10.
+inline uint8_t* write_varint(uint8_t* p, uint64_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    int n = (70 - __builtin_clzll(v | 1)) / 7;
+    // Spread the low 56 bits into eight 7-bit groups, halving the lane width each step.
+    uint64_t w = v & 0x00FFFFFFFFFFFFFFULL;
+    w = (w & 0x000000000FFFFFFFULL) | ((w & 0x00FFFFFFF0000000ULL) << 4);
+    w = (w & 0x00003FFF00003FFFULL) | ((w & 0x0FFFC0000FFFC000ULL) << 2);
+    w = (w & 0x007F007F007F007FULL) | ((w & 0x3F803F803F803F80ULL) << 1);
+    w |= 0x8080808080808080ULL & (n > 8 ? ~uint64_t(0) : (uint64_t(1) << (8 * (n - 1))) - 1);
+    std::memcpy(p, &w, 8);
+    p[8] = static_cast<uint8_t>(((v >> 56) & 0x7F) | (n > 9 ? 0x80 : 0));
+    p[9] = static_cast<uint8_t>(v >> 63);
+    return p + n;
+#else
+    for (; v >= 0x80; v >>= 7) {
+        *p++ = static_cast<uint8_t>(v | 0x80);
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
+#endif
+}
+
+// write_varint writes a 128-bit v as a little endian base 128 varint at p and returns its end.
+inline uint8_t* write_varint(uint8_t* p, unsigned __int128 v) {
+    for (; v >= 0x80; v >>= 7) {
+        *p++ = static_cast<uint8_t>(v | 0x80);
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
+}
+
+#if defined(__SSE2__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DECIMAL_SIMD_VARINT 1
+
+// varint_ends returns a bit for each of the kVarintWindow bytes at p that ends a varint,
+// that is has no continuation bit, found with a movemask per vector.
+constexpr std::size_t kVarintWindow = 64;
+
+inline uint64_t varint_ends(const uint8_t* p) {
+#if defined(__AVX2__)
+    auto lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))));
+    auto hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32))));
+    return ~(static_cast<uint64_t>(hi) << 32 | lo);
+#else
+    uint64_t more = 0;
+    for (int j = 0; j < 4; ++j) {
+        auto m = static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * j))));
+        more |= static_cast<uint64_t>(m) << (16 * j);
+    }
+    return ~more;
+#endif
+}
+
+// read_varint9 returns the varint of 1 <= n <= 9 bytes at p, which must have 9 readable
+// bytes, gathering its 7-bit groups without branches: the reverse of write_varint.
+inline uint64_t read_varint9(const uint8_t* p, unsigned n) {
+    uint64_t w;
+    std::memcpy(&w, p, 8);
+    // Keep the first n bytes, all eight when n is 9.
+    w &= ~uint64_t(0) >> (64 - 8 * n + 8 * (n > 8));
+#if defined(__BMI2__)
+    w = _pext_u64(w, 0x7F7F7F7F7F7F7F7FULL);
+#else
+    w &= 0x7F7F7F7F7F7F7F7FULL;
+    w = (w & 0x007F007F007F007FULL) | ((w & 0x7F007F007F007F00ULL) >> 1);
+    w = (w & 0x00003FFF00003FFFULL) | ((w & 0x3FFF00003FFF0000ULL) >> 2);
+    w = (w & 0x000000000FFFFFFFULL) | ((w & 0x0FFFFFFF00000000ULL) >> 4);
+#endif
+    return w | (static_cast<uint64_t>(p[8] & 0x7F) << 56 & (uint64_t(0) - (n > 8)));
+}
+#endif
+
+// shortest_chars writes the shortest decimal that reads back as f, in scientific notation,
+// and returns the end of it. Without floating-point std::to_chars it tries 15, 16 and 17
+// significant digits in turn.
+inline char* shortest_chars(char* first, char* last, double f) {
+#ifdef __cpp_lib_to_chars
+    return std::to_chars(first, last, f, std::chars_format::scientific).ptr;
+#else
+    int n = 0;
+    for (int precision = 14; precision <= 16; ++precision) {
+        n = std::snprintf(first, last - first, "%.*e", precision, f);
+        if (std::strtod(first, nullptr) == f) {
+            break;
+        }
+    }
+    return first + n;
+#endif
+}
+
+// read_double returns the correctly rounded double for the number in [first, last), which
+// must be followed by a NUL for strtod when floating-point std::from_chars is missing.
+inline double read_double(const char* first, const char* last) {
+#ifdef __cpp_lib_to_chars
+    double f = 0;
+    std::from_chars(first, last, f);
+    return f;
+#else
+    (void)last;
+    return std::strtod(first, nullptr);
+#endif
+}
+
+// Every power of ten that fits in unsigned __int128.
+inline constexpr auto wide_powers_of_10 = [] {
+    std::array<unsigned __int128, 39> powers{};
+    powers[0] = 1;
+    for (std::size_t i = 1; i < powers.size(); ++i) {
+        powers[i] = powers[i - 1] * 10;
+    }
+    return powers;
+}();
+
 template <typename T>
-inline T precomputed_pow_10(unsigned int exponent);
+constexpr T precomputed_pow_10(unsigned int exponent);
 
 template <>
-inline uint64_t precomputed_pow_10<uint64_t>(unsigned int exponent) {
-    constexpr std::array<uint64_t, 20> powers_of_10 = {1,
-                                                       10,
-                                                       100,
-                                                       1000,
-                                                       10000,
-                                                       100000,
-                                                       1000000,
-                                                       10000000,
-                                                       100000000,
-                                                       1000000000,
-                                                       10000000000,
-                                                       100000000000,
-                                                       1000000000000,
-                                                       10000000000000,
-                                                       100000000000000,
-                                                       1000000000000000,
-                                                       10000000000000000,
-                                                       100000000000000000,
-                                                       1000000000000000000,
-                                                       10000000000000000000UL};
-
-    constexpr unsigned int max_exponent = powers_of_10.size() - 1;
-    if (unlikely(exponent > max_exponent)) {
+constexpr uint64_t precomputed_pow_10<uint64_t>(unsigned int exponent) {
+    if (unlikely(exponent >= unsigned_powers_of_10.size())) {
         throw std::invalid_argument("invalid exponent for unsigned decimal");
     }
 
-    return powers_of_10[exponent];
+    return unsigned_powers_of_10[exponent];
 }
 
 template <>
-inline int64_t precomputed_pow_10<int64_t>(unsigned int exponent) {
-    constexpr std::array<int64_t, 19> powers_of_10 = {1,
-                                                      10,
-                                                      100,
-                                                      1000,
-                                                      10000,
-                                                      100000,
-                                                      1000000,
-                                                      10000000,
-                                                      100000000,
-                                                      1000000000,
-                                                      10000000000,
-                                                      100000000000,
-                                                      1000000000000,
-                                                      10000000000000,
-                                                      100000000000000,
-                                                      1000000000000000,
-                                                      10000000000000000,
-                                                      100000000000000000,
-                                                      1000000000000000000};
-
-    constexpr unsigned int max_exponent = powers_of_10.size() - 1;
-    if (unlikely(exponent > max_exponent)) {
+constexpr int64_t precomputed_pow_10<int64_t>(unsigned int exponent) {
+    if (unlikely(exponent >= signed_powers_of_10.size())) {
         throw std::invalid_argument("invalid exponent for signed decimal");
     }
 
-    return powers_of_10[exponent];
+    return signed_powers_of_10[exponent];
+}
+
+template <>
+constexpr unsigned __int128 precomputed_pow_10<unsigned __int128>(unsigned int exponent) {
+    if (unlikely(exponent >= wide_powers_of_10.size())) {
+        throw std::invalid_argument("invalid exponent for wide decimal");
+    }
+
+    return wide_powers_of_10[exponent];
+}
+
+template <>
+constexpr __int128 precomputed_pow_10<__int128>(unsigned int exponent) {
+    return static_cast<__int128>(precomputed_pow_10<unsigned __int128>(exponent));
+}
+
+// div_pow10_256 divides hi * 2^128 + lo by 10^n in place, 10^18 at a time. Instead of
+// the remainder it stores a rem and d that round_quotient treats the same way: twice the
+// last step's remainder, plus one if an earlier step left any, over twice its divisor.
+constexpr void div_pow10_256(unsigned __int128& hi, unsigned __int128& lo, unsigned int n, uint64_t& rem, uint64_t& d) {
+    bool sticky = false;
+    uint64_t r = 0, step = 1;
+    while (n > 0) {
+        unsigned int k = n < 18 ? n : 18;
+        sticky = sticky || r != 0;
+        step = unsigned_powers_of_10[k];
+        r = div_256_64(hi, lo, step);
+        n -= k;
+    }
+    rem = 2 * r + (sticky ? 1 : 0);
+    d = 2 * step;
+}
+
+// ProductSum is an exact sum of products of two IntType values, held as a two's
+// complement integer of hi and lo. Sums of 64-bit products need only 64 bits in hi and
+// cannot overflow; sums of 128-bit products that do not fit in 256 bits set overflow.
+template <Type S>
+struct ProductSum {
+    using IntType = typename IntTypeMap<S>::type;
+    using U = unsigned __int128;
+    using Hi = std::conditional_t<sizeof(IntType) == sizeof(int64_t), typename IntTypeMap<S>::type, U>;
+
+    Hi hi = 0;
+    U lo = 0;
+    bool overflow = false;
+
+    constexpr void add(IntType x, IntType y) {
+        if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+            if constexpr (is_signed(S)) {
+                auto p = static_cast<__int128>(x) * y;
+                lo += static_cast<U>(p);
+                hi += (lo < static_cast<U>(p) ? 1 : 0) - (p < 0 ? 1 : 0);
+            } else {
+                auto p = static_cast<U>(x) * y;
+                lo += p;
+                hi += lo < p ? 1 : 0;
+            }
+        } else {
+            bool neg = false;
+            U mx = static_cast<U>(x), my = static_cast<U>(y);
+            if constexpr (is_signed(S)) {
+                neg = (x < 0) != (y < 0);
+                mx = x < 0 ? 0 - mx : mx;
+                my = y < 0 ? 0 - my : my;
+            }
+            U ph = 0, pl = 0;
+            mul_256(mx, my, ph, pl);
+            if (neg) {
+                pl = 0 - pl;
+                ph = ~ph + (pl == 0 ? 1 : 0);
+            }
+
+            U old_hi = hi;
+            lo += pl;
+            U carry = ph + (lo < pl ? 1 : 0);
+            hi += carry;
+            if constexpr (is_signed(S)) {
+                overflow |= (old_hi >> 127) == (ph >> 127) && (hi >> 127) != (old_hi >> 127);
+            } else {
+                overflow |= carry < ph || hi < carry;
+            }
+        }
+    }
+
+    // magnitude stores |sum| as h * 2^128 + l and returns whether the sum is negative.
+    constexpr bool magnitude(U& h, U& l) const {
+        h = static_cast<U>(hi);
+        l = lo;
+        if (is_signed(S) && (h >> 127) != 0) {
+            l = 0 - lo;
+            h = ~h + (l == 0 ? 1 : 0);
+            return true;
+        }
+        return false;
+    }
+};
+
+// Vector sums split each 64-bit value into its low 32 bits, summed as unsigned, and its
+// high 32 bits, summed with the value's sign. Neither sum can overflow 64 bits within a
+// block of kSumBlock values, so the lanes need no carries.
+constexpr std::size_t kSumBlock = std::size_t(1) << 31;
+
+template <typename T>
+using SumHigh = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+
+#if defined(__AVX512F__)
+// sum_split_simd sums the largest multiple of 8 values it can into low and high, and
+// returns how many values that was.
+template <typename T>
+std::size_t sum_split_simd(const T* p, std::size_t n, uint64_t& low, SumHigh<T>& high) {
+    const __m512i mask = _mm512_set1_epi64(0xffffffff);
+    __m512i vlow = _mm512_setzero_si512();
+    __m512i vhigh = _mm512_setzero_si512();
+
+    // The zero-masked forms of the shifts, min and max below take an all-ones mask and
+    // compile to the plain instructions, without GCC 12's uninitialized warnings.
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i v = _mm512_loadu_si512(p + i);
+        vlow = _mm512_add_epi64(vlow, _mm512_and_si512(v, mask));
+        vhigh = _mm512_add_epi64(vhigh, std::is_signed_v<T> ? _mm512_maskz_srai_epi64(0xff, v, 32) : _mm512_maskz_srli_epi64(0xff, v, 32));
+    }
+    alignas(64) uint64_t lanes[16];
+    _mm512_store_si512(lanes, vlow);
+    _mm512_store_si512(lanes + 8, vhigh);
+    for (int j = 0; j < 8; ++j) {
+        low += lanes[j];
+        high += static_cast<SumHigh<T>>(lanes[j + 8]);
+    }
+    return i;
+}
+
+// minmax_simd lowers lo and raises hi to the smallest and largest of the largest multiple
+// of 8 values it can, and returns how many values that was.
+template <typename T>
+std::size_t minmax_simd(const T* p, std::size_t n, T& lo, T& hi) {
+    __m512i vlo = _mm512_set1_epi64(static_cast<int64_t>(lo));
+    __m512i vhi = _mm512_set1_epi64(static_cast<int64_t>(hi));
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i v = _mm512_loadu_si512(p + i);
+        if constexpr (std::is_signed_v<T>) {
+            vlo = _mm512_maskz_min_epi64(0xff, vlo, v);
+            vhi = _mm512_maskz_max_epi64(0xff, vhi, v);
+        } else {
+            vlo = _mm512_maskz_min_epu64(0xff, vlo, v);
+            vhi = _mm512_maskz_max_epu64(0xff, vhi, v);
+        }
+    }
+    alignas(64) T lanes[16];
+    _mm512_store_si512(lanes, vlo);
+    _mm512_store_si512(lanes + 8, vhi);
+    for (int j = 0; j < 8; ++j) {
+        lo = std::min(lo, lanes[j]);
+        hi = std::max(hi, lanes[j + 8]);
+    }
+    return i;
+}
+#elif defined(__AVX2__)
+template <typename T>
+std::size_t sum_split_simd(const T* p, std::size_t n, uint64_t& low, SumHigh<T>& high) {
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    __m256i vlow = _mm256_setzero_si256();
+    __m256i vhigh = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i h = _mm256_srli_epi64(v, 32);
+        if constexpr (std::is_signed_v<T>) {
+            // AVX2 has no 64-bit arithmetic shift, so the sign is blended into the top half.
+            h = _mm256_blend_epi32(h, _mm256_srai_epi32(v, 31), 0xaa);
+        }
+        vlow = _mm256_add_epi64(vlow, _mm256_and_si256(v, mask));
+        vhigh = _mm256_add_epi64(vhigh, h);
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), vlow);
+    low += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), vhigh);
+    high += static_cast<SumHigh<T>>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return i;
+}
+
+template <typename T>
+std::size_t minmax_simd(const T* p, std::size_t n, T& lo, T& hi) {
+    // AVX2 only compares signed lanes, so unsigned values are biased by the sign bit.
+    const __m256i bias = _mm256_set1_epi64x(std::is_signed_v<T> ? 0 : std::numeric_limits<int64_t>::min());
+    __m256i vlo = _mm256_set1_epi64x(static_cast<int64_t>(lo) ^ _mm256_extract_epi64(bias, 0));
+    __m256i vhi = _mm256_set1_epi64x(static_cast<int64_t>(hi) ^ _mm256_extract_epi64(bias, 0));
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias);
+        vlo = _mm256_blendv_epi8(vlo, v, _mm256_cmpgt_epi64(vlo, v));
+        vhi = _mm256_blendv_epi8(vhi, v, _mm256_cmpgt_epi64(v, vhi));
+    }
+
+    alignas(32) int64_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_xor_si256(vlo, bias));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes + 4), _mm256_xor_si256(vhi, bias));
+    for (int j = 0; j < 4; ++j) {
+        lo = std::min(lo, static_cast<T>(lanes[j]));
+        hi = std::max(hi, static_cast<T>(lanes[j + 4]));
+    }
+    return i;
+}
+#else
+template <typename T>
+std::size_t sum_split_simd(const T*, std::size_t, uint64_t&, SumHigh<T>&) {
+    return 0;
+}
+
+template <typename T>
+std::size_t minmax_simd(const T*, std::size_t, T&, T&) {
+    return 0;
+}
+#endif
+
+// sum_fp returns the exact sum of the n 64-bit values at p.
+template <typename T>
+auto sum_fp(const T* p, std::size_t n) {
+    using Wide = std::conditional_t<std::is_signed_v<T>, __int128, unsigned __int128>;
+    Wide total = 0;
+    for (std::size_t start = 0; start < n; start += kSumBlock) {
+        std::size_t m = std::min(n - start, kSumBlock);
+        const T* block = p + start;
+        uint64_t low = 0;
+        SumHigh<T> high = 0;
+        std::size_t i = sum_split_simd(block, m, low, high);
+        total += (static_cast<Wide>(high) << 32) + low;
+        for (; i < m; ++i) {
+            total += block[i];
+        }
+    }
+    return total;
+}
+
+// minmax_fp lowers lo and raises hi to the smallest and largest of the n values at p.
+template <typename T>
+void minmax_fp(const T* p, std::size_t n, T& lo, T& hi) {
+    std::size_t i = 0;
+    if constexpr (sizeof(T) == sizeof(int64_t)) {
+        i = minmax_simd(p, n, lo, hi);
+    }
+    for (; i < n; ++i) {
+        lo = std::min(lo, p[i]);
+        hi = std::max(hi, p[i]);
+    }
+}
+
+// Doubles are converted with one multiply when f * scale is below 2^50 and further than
+// kDoubleMargin times itself from a rounding boundary. The product is then within a few
+// ulps of both the exact value of f and its shortest decimal, times scale, so all three
+// round to the same integer.
+constexpr double kDoubleMargin = 0x1p-49;
+
+// round_int64 rounds f to an integer in the current rounding mode, f must fit.
+inline long long round_int64(double f) {
+#if defined(__SSE2__) && defined(__x86_64__)
+    return _mm_cvtsd_si64(_mm_set_sd(f));  // std::llrint is a libm call unless -fno-math-errno
+#else
+    return std::llrint(f);
+#endif
+}
+
+#if defined(__AVX512F__)
+// doubles_to_fp_simd converts blocks of 8 doubles on the fast path into out, stopping at
+// the first block with a lane that is not, and returns how many values it converted.
+template <typename T>
+std::size_t doubles_to_fp_simd(const double* p, std::size_t n, T* out, double scale) {
+    const __m512d vscale = _mm512_set1_pd(scale);
+    const __m512d limit = _mm512_set1_pd(0x1p50);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d margin = _mm512_set1_pd(kDoubleMargin);
+    const __m512d magic = _mm512_set1_pd(0x1p52);
+    const __m512d zero = _mm512_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d y = _mm512_mul_pd(_mm512_loadu_pd(p + i), vscale);
+        __m512d a = _mm512_abs_pd(y);
+        // The zero-masked form avoids GCC 12's uninitialized warning, as for sum_split_simd.
+        __m512d t = _mm512_maskz_roundscale_pd(0xff, a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m512d frac = _mm512_sub_pd(a, t);
+        __m512d off = _mm512_abs_pd(_mm512_sub_pd(frac, half));
+
+        __mmask8 ok = _mm512_cmp_pd_mask(a, limit, _CMP_LT_OQ) & _mm512_cmp_pd_mask(off, _mm512_mul_pd(a, margin), _CMP_GT_OQ);
+        __mmask8 neg = _mm512_cmp_pd_mask(y, zero, _CMP_LT_OQ);
+        if constexpr (!std::is_signed_v<T>) {
+            ok &= ~neg;
+        }
+        if (unlikely(ok != 0xff)) {
+            break;
+        }
+
+        // Adding 2^52 leaves the integer in the low mantissa bits.
+        __m512d q = _mm512_add_pd(_mm512_add_pd(t, _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(frac, half, _CMP_GT_OQ), _mm512_set1_pd(1.0))), magic);
+        __m512i r = _mm512_sub_epi64(_mm512_castpd_si512(q), _mm512_castpd_si512(magic));
+        r = _mm512_mask_sub_epi64(r, neg, _mm512_setzero_si512(), r);
+        _mm512_storeu_si512(out + i, r);
+    }
+    return i;
+}
+#elif defined(__AVX2__)
+// doubles_to_fp_simd converts blocks of 4 doubles on the fast path into out, stopping at
+// the first block with a lane that is not, and returns how many values it converted.
+template <typename T>
+std::size_t doubles_to_fp_simd(const double* p, std::size_t n, T* out, double scale) {
+    const __m256d vscale = _mm256_set1_pd(scale);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d limit = _mm256_set1_pd(0x1p50);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d margin = _mm256_set1_pd(kDoubleMargin);
+    const __m256d magic = _mm256_set1_pd(0x1p52);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d y = _mm256_mul_pd(_mm256_loadu_pd(p + i), vscale);
+        __m256d a = _mm256_andnot_pd(sign, y);
+        __m256d t = _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256d frac = _mm256_sub_pd(a, t);
+        __m256d off = _mm256_andnot_pd(sign, _mm256_sub_pd(frac, half));
+
+        __m256d ok = _mm256_and_pd(_mm256_cmp_pd(a, limit, _CMP_LT_OQ), _mm256_cmp_pd(off, _mm256_mul_pd(a, margin), _CMP_GT_OQ));
+        __m256d neg = _mm256_cmp_pd(y, _mm256_setzero_pd(), _CMP_LT_OQ);
+        if constexpr (!std::is_signed_v<T>) {
+            ok = _mm256_andnot_pd(neg, ok);
+        }
+        if (unlikely(_mm256_movemask_pd(ok) != 0xf)) {
+            break;
+        }
+
+        // Adding 2^52 leaves the integer in the low mantissa bits.
+        __m256d q = _mm256_add_pd(_mm256_add_pd(t, _mm256_and_pd(_mm256_cmp_pd(frac, half, _CMP_GT_OQ), one)), magic);
+        __m256i r = _mm256_sub_epi64(_mm256_castpd_si256(q), _mm256_castpd_si256(magic));
+        __m256i m = _mm256_castpd_si256(neg);
+        r = _mm256_sub_epi64(_mm256_xor_si256(r, m), m);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+    }
+    return i;
+}
+#else
+template <typename T>
+std::size_t doubles_to_fp_simd(const double*, std::size_t, T*, double) {
+    return 0;
+}
+#endif
+
+// fp values below 2^51 become doubles by setting them as the mantissa of 2^52, and the
+// quotient by scale is corrected with an FMA (Markstein): with inv the rounded 1 / scale,
+// q = fp * inv is within an ulp and q + (fp - q * scale) * inv is correctly rounded.
+#if defined(__AVX512F__)
+// fp_to_doubles_simd converts blocks of 8 fp values below 2^51 into out, stopping at the
+// first block with a lane that is not, and returns how many values it converted.
+template <typename T>
+std::size_t fp_to_doubles_simd(const T* p, std::size_t n, double* out, double scale) {
+    const __m512d vscale = _mm512_set1_pd(scale);
+    const __m512d inv = _mm512_set1_pd(1.0 / scale);
+    const __m512i bias = _mm512_set1_epi64(std::is_signed_v<T> ? int64_t(1) << 51 : 0);
+    const __m512i limit = _mm512_set1_epi64(int64_t(1) << 52);
+    const __m512i exponent = _mm512_set1_epi64(0x4330000000000000);
+    const __m512d offset = _mm512_set1_pd(std::is_signed_v<T> ? 0x1p52 + 0x1p51 : 0x1p52);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i u = _mm512_add_epi64(_mm512_loadu_si512(p + i), bias);
+        if (unlikely(_mm512_cmplt_epu64_mask(u, limit) != 0xff)) {
+            break;
+        }
+        __m512d x = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(u, exponent)), offset);
+        __m512d q = _mm512_mul_pd(x, inv);
+        q = _mm512_fmadd_pd(_mm512_fnmadd_pd(q, vscale, x), inv, q);
+        _mm512_storeu_pd(out + i, q);
+    }
+    return i;
+}
+#elif defined(__AVX2__)
+// fp_to_doubles_simd converts blocks of 4 fp values below 2^51 into out, stopping at the
+// first block with a lane that is not, and returns how many values it converted.
+template <typename T>
+std::size_t fp_to_doubles_simd(const T* p, std::size_t n, double* out, double scale) {
+    const __m256d vscale = _mm256_set1_pd(scale);
+    const __m256i bias = _mm256_set1_epi64x(std::is_signed_v<T> ? int64_t(1) << 51 : 0);
+    // AVX2 has no unsigned compare, so values are checked by their bits above 52.
+    const __m256i high = _mm256_set1_epi64x(~((int64_t(1) << 52) - 1));
+    const __m256i exponent = _mm256_set1_epi64x(0x4330000000000000);
+    const __m256d offset = _mm256_set1_pd(std::is_signed_v<T> ? 0x1p52 + 0x1p51 : 0x1p52);
+#ifdef __FMA__
+    const __m256d inv = _mm256_set1_pd(1.0 / scale);
+#endif
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i u = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias);
+        if (unlikely(!_mm256_testz_si256(u, high))) {
+            break;
+        }
+        __m256d x = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(u, exponent)), offset);
+#ifdef __FMA__
+        __m256d q = _mm256_mul_pd(x, inv);
+        q = _mm256_fmadd_pd(_mm256_fnmadd_pd(q, vscale, x), inv, q);
+#else
+        __m256d q = _mm256_div_pd(x, vscale);
+#endif
+        _mm256_storeu_pd(out + i, q);
+    }
+    return i;
+}
+#else
+template <typename T>
+std::size_t fp_to_doubles_simd(const T*, std::size_t, double*, double) {
+    return 0;
 }
+#endif
 
 }  // namespace detail
 
+// DecodeResult is what Decimal::decode_binary returns for a range of bytes: the value, the
+// number of bytes it took, and std::errc() or why decoding failed, std::from_chars style.
+template <typename D>
+struct DecodeResult {
+    D value;
+    std::size_t size;
+    std::errc ec;
+};
+
 // Decimal is a decimal precision for signed and unsigned numbers (defaults to 11.8 digits unsigned).
-template <int nPlaces = 8, Type S = Unsigned>
+template <int nPlaces = 8, Type S = Unsigned, Overflow P = Overflow::Throw>
 class Decimal {
    private:
     static constexpr double computeMax() {
-        return static_cast<double>(detail::const_pow<10, (digits - nPlaces)>() - 1) + (static_cast<double>(scale - 1) / static_cast<double>(scale));
+        return static_cast<double>(detail::const_pow<10, (digits - nPlaces), UIntType>() - 1) +
+               (static_cast<double>(scale - 1) / static_cast<double>(scale));
     }
 
     static constexpr double computeMin() {
-        if constexpr (S == Signed) {
+        if constexpr (detail::is_signed(S)) {
             return -computeMax();
         }
         return 0;
@@ -149,18 +1179,23 @@ class Decimal {
 
    public:
     using IntType = typename detail::IntTypeMap<S>::type;
+    using UIntType = typename detail::IntTypeMap<S>::utype;
 
     IntType fp = 0;
 
-    explicit Decimal(int i) { fp = static_cast<IntType>(i) * scale; }
+    constexpr explicit Decimal(int i) { fp = static_cast<IntType>(i) * scale; }
 
-    Decimal(IntType fp = 0) : fp(fp) {}
+    constexpr Decimal(IntType fp = 0) : fp(fp) {}
 
-    static constexpr IntType scale = detail::const_pow<10, nPlaces>();
-    static constexpr int digits = std::numeric_limits<IntType>::digits10;
+    static constexpr IntType scale = detail::const_pow<10, nPlaces, IntType>();
+    static constexpr int digits = detail::IntTypeMap<S>::digits10;
     static constexpr double MAX = computeMax();
     static constexpr double MIN = computeMin();
 
+    // The largest and smallest raw fp values, MAX and MIN times scale.
+    static constexpr IntType max_fp = detail::const_pow<10, digits, IntType>() - 1;
+    static constexpr IntType min_fp = detail::is_signed(S) ? -max_fp : 0;
+
     static_assert(nPlaces < digits);
     static_assert(nPlaces > 0);
 
@@ -171,495 +1206,2026 @@ class Decimal {
     static const std::overflow_error errOverflow;
     static const std::invalid_argument errInvalidInput;
 
-    Decimal(const Decimal<nPlaces>& other) : fp(other.fp) {}
+    // Copies, or converts from the default Unsigned Decimal with the same places when
+    // there is one, which wide Decimals with more than 18 places have not.
+    using Default = std::conditional_t<(nPlaces < detail::IntTypeMap<Unsigned>::digits10), Decimal<nPlaces>, Decimal>;
+    constexpr Decimal(const Default& other) : fp(other.fp) {}
+
+    // Converts between overflow policies; the value is unchanged.
+    template <Overflow Q, typename = std::enable_if_t<Q != P>>
+    constexpr explicit Decimal(const Decimal<nPlaces, S, Q>& other) : fp(other.fp) {}
+
+    // Creates a Decimal from a double, rounding its shortest round-trip decimal, the one
+    // printed by std::to_chars, half away from zero at the nth place. So 1.005 becomes
+    // 1.01 with two places, although the double itself is slightly below 1.005.
+    Decimal(double f) {
+        auto ec = from_double(f, fp);
+        if (unlikely(ec == std::errc::invalid_argument)) {
+            throw errInvalidInput;
+        } else if (unlikely(ec != std::errc())) {
+            throw errOverflow;
+        }
+    }
+
+    // from_doubles converts the doubles in [first, last) into out like Decimal(double),
+    // stopping at the first one that is not finite or does not fit, and returns the number
+    // converted. Most values are converted a vector at a time with AVX-512 or AVX2.
+    static std::size_t from_doubles(const double* first, const double* last, Decimal* out) {
+        auto n = static_cast<std::size_t>(last - first);
+        std::size_t i = 0;
+        while (i < n) {
+            if constexpr (!is_wide && nPlaces <= 22) {
+                i += detail::doubles_to_fp_simd(first + i, n - i, &out[i].fp, static_cast<double>(scale));
+                if (i == n) {
+                    break;
+                }
+            }
+            if (unlikely(from_double(first[i], out[i].fp) != std::errc())) {
+                return i;
+            }
+            ++i;
+        }
+        return n;
+    }
+
+#ifdef __cpp_lib_span
+    static std::size_t from_doubles(std::span<const double> values, Decimal* out) {
+        return from_doubles(values.data(), values.data() + values.size(), out);
+    }
+#endif
+
+    // Creates a Decimal for an integer, moving the decimal point n places to the left
+    // For example, Decimal(123,1) becomes 12.3. If n > 7, the value is truncated
+    constexpr Decimal(IntType i, uint32_t n) { fp = newI(i, n); }
+
+    // Creates a Decimal by parsing a string such as "-123.456". Digits beyond the nth
+    // place are truncated.
+    constexpr Decimal(std::string_view s) : Decimal(s.data(), s.data() + s.size()) {}
+    Decimal(const std::string& s) : Decimal(s.data(), s.data() + s.size()) {}
+    constexpr Decimal(const char* s) : Decimal(std::string_view(s)) {}
+
+    // Creates a Decimal by parsing the characters in [first, last) in a single pass,
+    // without allocating. Templated so that a literal (0, 0) still selects Decimal(i, n).
+    template <typename Char, typename = std::enable_if_t<std::is_same_v<Char, char>>>
+    constexpr Decimal(const Char* first, const Char* last) {
+        auto [ptr, ec] = parse(first, last, fp);
+        if (unlikely(ec == std::errc::result_out_of_range)) {
+            throw errTooLarge;
+        }
+        if (unlikely(ec != std::errc() || ptr != last)) {
+            throw errInvalidInput;
+        }
+    }
+
+    // parse_batch parses the fields in [first, last) into out, stopping at the first field
+    // that is not a valid Decimal, and returns the number of values parsed. Plain fields of
+    // up to 16 characters are validated and converted 16 digits at a time; anything else (an
+    // exponent, extra fraction digits, ...) falls back to the scalar parser.
+    static std::size_t parse_batch(const std::string_view* first, const std::string_view* last, Decimal* out) {
+        std::size_t n = 0;
+        for (const std::string_view* it = first; it != last; ++it, ++n) {
+            if (likely(parseFixed(it->data(), it->size(), out[n].fp))) {
+                continue;
+            }
+
+            const char* end = it->data() + it->size();
+            auto [ptr, ec] = parse(it->data(), end, out[n].fp);
+            if (unlikely(ec != std::errc() || ptr != end)) {
+                break;
+            }
+        }
+        return n;
+    }
+
+#ifdef __cpp_lib_span
+    static std::size_t parse_batch(std::span<const std::string_view> fields, Decimal* out) {
+        return parse_batch(fields.data(), fields.data() + fields.size(), out);
+    }
+#endif
+
+    // New returns a new fixed-point decimal, value * 10 ^ exp.
+    static constexpr Decimal FromExp(IntType value, int exp) {
+        if (exp >= 0) {
+            auto exp_mul = detail::precomputed_pow_10<IntType>(exp);
+            return {mul(newI(value, 0), newI(exp_mul, 0))};
+        }
+
+        return {newI(value, static_cast<unsigned int>(-exp))};
+    }
+
+    [[nodiscard]] constexpr bool is_zero() const { return fp == 0; }
+
+    // to_double returns the double nearest to the Decimal. Below 2^53 both fp and scale are
+    // exact doubles so one division is correctly rounded; larger values read back their digits.
+    [[nodiscard]] constexpr double to_double() const {
+        if constexpr (nPlaces <= 22) {
+            constexpr IntType exact = IntType(1) << 53;
+            if (likely(fp < exact && (!detail::is_signed(S) || fp > -exact))) {
+                return static_cast<double>(fp) / static_cast<double>(scale);
+            }
+        }
+        return to_double_digits();
+    }
+
+    // to_doubles converts the Decimals in [first, last) into out like to_double. Values below
+    // 2^51 are converted a vector at a time with AVX-512 or AVX2.
+    static void to_doubles(const Decimal* first, const Decimal* last, double* out) {
+        auto n = static_cast<std::size_t>(last - first);
+        std::size_t i = 0;
+        while (i < n) {
+            if constexpr (!is_wide && nPlaces <= 22) {
+                i += detail::fp_to_doubles_simd(&first[i].fp, n - i, out + i, static_cast<double>(scale));
+                if (i == n) {
+                    break;
+                }
+            }
+            out[i] = first[i].to_double();
+            ++i;
+        }
+    }
+
+#ifdef __cpp_lib_span
+    static void to_doubles(std::span<const Decimal> values, double* out) { to_doubles(values.data(), values.data() + values.size(), out); }
+#endif
+
+    // Add adds f0 to f producing a Decimal.
+    constexpr Decimal operator+(const Decimal& f0) const {
+        if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+            return {static_cast<IntType>(static_cast<UIntType>(fp) + static_cast<UIntType>(f0.fp))};
+        } else {
+            Decimal r;
+            if (unlikely(checked_add(f0, r) != std::errc())) {
+                return {overflowed(sum_negative(fp, f0.fp))};
+            }
+            return r;
+        }
+    }
+
+    // Adds f0 to the current Decimal object.
+    constexpr Decimal& operator+=(const Decimal& f0) {
+        *this = *this + f0;
+        return *this;
+    }
+
+    // Sub subtracts f0 from f producing a Decimal.
+    constexpr Decimal operator-(const Decimal& f0) const {
+        if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+            return {static_cast<IntType>(static_cast<UIntType>(fp) - static_cast<UIntType>(f0.fp))};
+        } else {
+            Decimal r;
+            if (unlikely(checked_sub(f0, r) != std::errc())) {
+                return {overflowed(difference_negative(fp, f0.fp))};
+            }
+            return r;
+        }
+    }
+
+    // Subtracts f0 from the current Decimal object.
+    constexpr Decimal& operator-=(const Decimal& f0) {
+        *this = *this - f0;
+        return *this;
+    }
+
+    // Negates a signed Decimal, which cannot overflow as [min_fp, max_fp] is symmetric.
+    template <Type T = S, typename = std::enable_if_t<detail::is_signed(T)>>
+    constexpr Decimal operator-() const {
+        return {static_cast<IntType>(0 - static_cast<UIntType>(fp))};
+    }
+
+    constexpr Decimal operator*(const Decimal& f0) const { return {mul(fp, f0.fp)}; }
+
+    // multiplies the current Decimal object by f0.
+    constexpr Decimal& operator*=(const Decimal& f0) {
+        fp = mul(fp, f0.fp);
+        return *this;
+    }
+
+    // mul returns *this * f0 rounded according to R, where operator* truncates.
+    template <Rounding R>
+    [[nodiscard]] constexpr Decimal mul(const Decimal& f0) const {
+        return {mul<R>(fp, f0.fp)};
+    }
+
+    // mul returns *this * f0 with toPlaces places, rounded according to R, where f0 may
+    // have different places. The rescale is folded into the exact product, so neither
+    // operand is converted first.
+    template <int toPlaces, Rounding R = Rounding::Truncate, int fromPlaces>
+    [[nodiscard]] constexpr Decimal<toPlaces, S, P> mul(const Decimal<fromPlaces, S, P>& f0) const {
+        return {Decimal<toPlaces, S, P>::template rescaled_mul<R, nPlaces + fromPlaces>(fp, f0.fp)};
+    }
+
+    // div returns *this / f0 with toPlaces places, where f0 may have different places,
+    // rounded according to R (half away from zero like operator/ by default).
+    template <int toPlaces, Rounding R = Rounding::HalfUp, int fromPlaces>
+    [[nodiscard]] constexpr Decimal<toPlaces, S, P> div(const Decimal<fromPlaces, S, P>& f0) const {
+        return {Decimal<toPlaces, S, P>::template rescaled_div<R, toPlaces - nPlaces + fromPlaces>(fp, f0.fp)};
+    }
+
+    constexpr Decimal operator/(const Decimal& f0) const { return {div(fp, f0.fp)}; }
+
+    // divides the current Decimal object by f0.
+    constexpr Decimal& operator/=(const Decimal& f0) {
+        fp = div(fp, f0.fp);
+        return *this;
+    }
+
+    // The checked_ functions compute the same results as the operators without throwing.
+    // On success they store the result in out and return std::errc(); otherwise out is
+    // left untouched and they return std::errc::result_out_of_range on overflow, or
+    // std::errc::argument_out_of_domain on division by zero.
+    [[nodiscard]] constexpr std::errc checked_add(const Decimal& f0, Decimal& out) const {
+        IntType r = 0;
+        if (unlikely(__builtin_add_overflow(fp, f0.fp, &r) || r > max_fp || r < min_fp)) {
+            return std::errc::result_out_of_range;
+        }
+        out.fp = r;
+        return {};
+    }
+
+    [[nodiscard]] constexpr std::errc checked_sub(const Decimal& f0, Decimal& out) const {
+        IntType r = 0;
+        if (unlikely(__builtin_sub_overflow(fp, f0.fp, &r) || r > max_fp || r < min_fp)) {
+            return std::errc::result_out_of_range;
+        }
+        out.fp = r;
+        return {};
+    }
+
+    template <Rounding R = Rounding::Truncate>
+    [[nodiscard]] constexpr std::errc checked_mul(const Decimal& f0, Decimal& out) const {
+        IntType r = 0;
+        if (unlikely(!try_mul<R>(fp, f0.fp, r))) {
+            return std::errc::result_out_of_range;
+        }
+        out.fp = r;
+        return {};
+    }
+
+    // checked_fma stores fp * b + c in out with a single rounding according to R, like fma.
+    template <Rounding R = Rounding::Truncate>
+    [[nodiscard]] constexpr std::errc checked_fma(const Decimal& b, const Decimal& c, Decimal& out) const {
+        detail::ProductSum<S> sum;
+        sum.add(fp, b.fp);
+        sum.add(c.fp, scale);
+        IntType r = 0;
+        if (unlikely((!try_rescaled_sum<R, nPlaces>(sum, r)))) {
+            return std::errc::result_out_of_range;
+        }
+        out.fp = r;
+        return {};
+    }
+
+    [[nodiscard]] constexpr std::errc checked_div(const Decimal& f0, Decimal& out) const {
+        IntType r = 0;
+        auto ec = try_div(fp, f0.fp, r);
+        if (likely(ec == std::errc())) {
+            out.fp = r;
+        }
+        return ec;
+    }
+
+    // Accumulator sums Decimals in an integer too wide to overflow: 128 bits for 64-bit
+    // Decimals, which would take 2^63 additions to fill, and 192 bits for wide ones. The
+    // range is checked once, when value narrows the total back to a Decimal. Accumulators
+    // over parts of a range can be merged with += in any order for the same total.
+    class Accumulator {
+       public:
+        constexpr Accumulator() = default;
+
+        constexpr Accumulator& operator+=(const Decimal& d) {
+            if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+                lo += d.fp;
+            } else {
+                add(static_cast<UIntType>(d.fp), is_negative(d.fp) ? -1 : 0);
+            }
+            return *this;
+        }
+
+        constexpr Accumulator& operator+=(const Accumulator& other) {
+            if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+                lo += other.lo;
+            } else {
+                add(static_cast<UIntType>(other.lo), other.carry);
+            }
+            return *this;
+        }
+
+        // add adds the n Decimals at first. 64-bit Decimals are summed a vector at a time.
+        Accumulator& add(const Decimal* first, std::size_t n) {
+            if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+                lo += detail::sum_fp(&first->fp, n);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) {
+                    *this += first[i];
+                }
+            }
+            return *this;
+        }
+
+        // value returns the total, applying P if it does not fit in a Decimal.
+        [[nodiscard]] constexpr Decimal value() const {
+            if constexpr (P == Overflow::Throw || P == Overflow::Saturate) {
+                if (unlikely(!fits())) {
+                    return {overflowed(negative())};
+                }
+            }
+            return {static_cast<IntType>(lo)};
+        }
+
+        // mean returns the total divided by count, rounded according to R, and applies P if
+        // that does not fit in a Decimal.
+        template <Rounding R = Rounding::HalfUp>
+        [[nodiscard]] constexpr Decimal mean(std::size_t count) const {
+            if (unlikely(count == 0)) {
+                throw errDivByZero;
+            }
+            unsigned __int128 h = 0, l = 0;
+            bool neg = magnitude(h, l);
+            uint64_t rem = detail::div_256_64(h, l, count);
+            bool fits = h == 0 && (sizeof(IntType) > sizeof(int64_t) || (l >> 64) == 0);
+            return {rescaled_result<R>(static_cast<UIntType>(l), rem, count, neg, fits)};
+        }
+
+        // checked_value stores the total in out and returns std::errc(), or returns
+        // std::errc::result_out_of_range and leaves out untouched if it does not fit.
+        [[nodiscard]] constexpr std::errc checked_value(Decimal& out) const {
+            if (unlikely(!fits())) {
+                return std::errc::result_out_of_range;
+            }
+            out.fp = static_cast<IntType>(lo);
+            return {};
+        }
+
+       private:
+        using Wide = std::conditional_t<detail::is_signed(S), __int128, unsigned __int128>;
+
+        // add adds the 192-bit two's complement value c * 2^128 + v.
+        constexpr void add(UIntType v, int64_t c) {
+            UIntType sum = static_cast<UIntType>(lo) + v;
+            carry += c + (sum < v ? 1 : 0);
+            lo = static_cast<Wide>(sum);
+        }
+
+        constexpr bool negative() const {
+            if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+                return lo < 0;
+            } else {
+                return carry < 0;
+            }
+        }
+
+        // magnitude stores |total| as h * 2^128 + l and returns whether it is negative.
+        constexpr bool magnitude(unsigned __int128& h, unsigned __int128& l) const {
+            bool neg = negative();
+            l = static_cast<unsigned __int128>(lo);
+            if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+                h = neg ? ~static_cast<unsigned __int128>(0) : 0;
+            } else {
+                h = static_cast<unsigned __int128>(static_cast<__int128>(carry));
+            }
+            if (neg) {
+                l = 0 - l;
+                h = ~h + (l == 0 ? 1 : 0);
+                return true;
+            }
+            return false;
+        }
+
+        constexpr bool fits() const {
+            if constexpr (sizeof(IntType) > sizeof(int64_t)) {
+                // Only the two's complement extension of a 128-bit lo can fit.
+                if (carry != (detail::is_signed(S) && lo < 0 ? -1 : 0)) {
+                    return false;
+                }
+            }
+            return lo <= max_fp && lo >= min_fp;
+        }
+
+        // The total is carry * 2^128 + lo, where carry is only used by wide Decimals.
+        Wide lo = 0;
+        int64_t carry = 0;
+    };
+
+    constexpr bool operator==(const Decimal& rhs) const { return fp == rhs.fp; }
+    constexpr bool operator!=(const Decimal& rhs) const { return fp != rhs.fp; }
+    constexpr bool operator<(const Decimal& rhs) const { return fp < rhs.fp; }
+    constexpr bool operator<=(const Decimal& rhs) const { return fp <= rhs.fp; }
+    constexpr bool operator>(const Decimal& rhs) const { return fp > rhs.fp; }
+    constexpr bool operator>=(const Decimal& rhs) const { return fp >= rhs.fp; }
+
+    // Longest text to_chars can produce: a sign, every digit of IntType and the point.
+    static constexpr std::size_t max_chars = digits + 3;
+
+    // to_chars writes the Decimal into [first, last) without allocating, trimming trailing
+    // zeros like to_string(). ptr is one past the last character written, or last with
+    // ec set to value_too_large if the buffer is too small.
+    std::to_chars_result to_chars(char* first, char* last) const {
+        std::array<char, max_chars> buf;
+        char* end = buf.data() + buf.size();
+        char* begin = format(end);
+
+        char* point = end - nPlaces - 1;
+        while (end > point + 1 && end[-1] == '0') {
+            --end;
+        }
+        if (end == point + 1) {
+            end = point;
+        }
+
+        return copyChars(begin, end, first, last);
+    }
+
+    // to_chars writes the Decimal into [first, last) with exactly decimals places
+    // (at most nPlaces), truncating like to_string(decimals).
+    std::to_chars_result to_chars(char* first, char* last, int decimals) const {
+        std::array<char, max_chars> buf;
+        char* end = buf.data() + buf.size();
+        char* begin = format(end);
+
+        char* point = end - nPlaces - 1;
+        if (decimals <= 0) {
+            end = point;
+        } else if (decimals < nPlaces) {
+            end = point + 1 + decimals;
+        }
+
+        return copyChars(begin, end, first, last);
+    }
+
+    [[nodiscard]] std::string to_string() const {
+        std::array<char, max_chars> buf;
+        auto res = to_chars(buf.data(), buf.data() + buf.size());
+        return {buf.data(), res.ptr};
+    }
+
+    [[nodiscard]] std::string to_string(int decimals) const {
+        std::array<char, max_chars> buf;
+        auto res = to_chars(buf.data(), buf.data() + buf.size(), decimals);
+        return {buf.data(), res.ptr};
+    }
+
+    [[nodiscard]] constexpr IntType to_int() const { return fp / scale; }
+
+    [[nodiscard]] constexpr double to_frac() const { return static_cast<double>(fp % scale) / scale; }
+
+    [[nodiscard]] constexpr Decimal round(int n) const {
+        if (n >= nPlaces) {
+            return *this;
+        }
+
+        if (n == 0) {
+            return fp - (fp % scale);
+        }
+
+        IntType frac = fp % scale;
+        IntType f0 = fp - frac;
+
+        unsigned int places = nPlaces - n;
+        auto pow = static_cast<UIntType>(detail::precomputed_pow_10<IntType>(places));
+        UIntType m = magnitude(frac) + pow / 2;  // rounding factor
+        m = div_pow10(m, places) * pow;
+
+        return {f0 + with_sign(m, is_negative(frac))};
+    }
+
+    // convert_precision allows converting a Decimal from one precision to another.
+    // A conversion  moving the number of places right, will just be a lossy conversion
+    // A conversion moving the number of places left overflows, as set by P, if the
+    // value does not fit
+    template <int toPlaces>
+    constexpr Decimal<toPlaces, S, P> convert_precision() const {
+        if constexpr (toPlaces == nPlaces) {
+            return Decimal<toPlaces, S, P>(*this);
+        } else if constexpr (toPlaces < nPlaces) {
+            constexpr auto factor = static_cast<UIntType>(scale / detail::const_pow<10, toPlaces, IntType>());
+            bool neg = is_negative(fp);
+            UIntType m = detail::div_round<Rounding::HalfUp>(magnitude(fp), factor, neg);
+            return Decimal<toPlaces, S, P>(static_cast<typename Decimal<toPlaces, S, P>::IntType>(with_sign(m, neg)));
+        } else {
+            constexpr IntType factor = detail::const_pow<10, toPlaces, IntType>() / scale;
+            if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+                return Decimal<toPlaces, S, P>(static_cast<IntType>(static_cast<UIntType>(fp) * factor));
+            } else {
+                // Both types share max_fp and min_fp, which depend only on IntType.
+                if (unlikely(fp > max_fp / factor || fp < min_fp / factor)) {
+                    return Decimal<toPlaces, S, P>(overflowed(is_negative(fp)));
+                }
+                return Decimal<toPlaces, S, P>(fp * factor);
+            }
+        }
+    }
+
+    // decode_binary reads from a byte vector and sets the Decimal value
+    // It also updates the offset. Throws if the bytes end early or the value does not fit.
+    void decode_binary(const std::vector<uint8_t>& data, size_t& offset) {
+        size_t start = std::min(offset, data.size());
+        auto res = decode_binary(data.data() + start, data.size() - start);
+        if (unlikely(res.ec == std::errc::invalid_argument)) {
+            throw errInvalidInput;
+        } else if (unlikely(res.ec != std::errc())) {
+            throw errOverflow;
+        }
+        fp = res.value.fp;
+        offset = start + res.size;
+    }
+
+    // decode_binary decodes one value written by encode_binary from the size bytes at data
+    // without copying or reading past them, and returns it with the number of bytes used.
+    // ec is std::errc::invalid_argument if the bytes end early or the format is unknown, and
+    // std::errc::result_out_of_range if the value does not fit. Values with more places than
+    // nPlaces are truncated.
+    static DecodeResult<Decimal> decode_binary(const uint8_t* data, std::size_t size) noexcept {
+        UIntType value = 0;
+        std::size_t i = 0;
+        std::errc ec = read_varint(data, size, i, value);
+        if (unlikely(ec != std::errc())) {
+            return {{}, i, ec};
+        }
+
+        // The header byte with the places and format follows it.
+        if (unlikely(i == size)) {
+            return {{}, i, std::errc::invalid_argument};
+        }
+        IntType out = 0;
+        ec = from_varint(value, data[i++], out);
+        return {Decimal(out), i, ec};
+    }
+
+#ifdef __cpp_lib_span
+    static DecodeResult<Decimal> decode_binary(std::span<const uint8_t> data) noexcept { return decode_binary(data.data(), data.size()); }
+#endif
+
+    // decode_binary_batch decodes up to n values written back to back by encode_binary from
+    // the size bytes at data into out. The result's value is the number decoded and size the
+    // bytes they took. It stops early without error where the bytes end between values, and
+    // with ec set as for decode_binary at a value that does not decode. Most values are read
+    // without a branch per byte, see decode_varints.
+    static DecodeResult<std::size_t> decode_binary_batch(const uint8_t* data, std::size_t size, Decimal* out, std::size_t n) noexcept {
+        return decode_varints<false>(data, size, 0, out, n);
+    }
+
+    // encode_binary_stream writes the Decimals in [first, last) to out as one header byte
+    // followed by their varints, saving a byte per value over encode_binary_batch. out must
+    // have room for max_encoded_size bytes per value plus one, and it returns the bytes written.
+    static std::size_t encode_binary_stream(const Decimal* first, const Decimal* last, uint8_t* out) {
+        uint8_t* p = out;
+        *p++ = binary_header;
+        for (; first != last; ++first) {
+            p = detail::write_varint(p, to_varint(first->fp));
+        }
+        return static_cast<std::size_t>(p - out);
+    }
+
+    // decode_binary_stream decodes up to n values written by encode_binary_stream, like
+    // decode_binary_batch. size in the result includes the header byte.
+    static DecodeResult<std::size_t> decode_binary_stream(const uint8_t* data, std::size_t size, Decimal* out, std::size_t n) noexcept {
+        if (unlikely(size == 0)) {
+            return {0, 0, n == 0 ? std::errc() : std::errc::invalid_argument};
+        }
+        auto res = decode_varints<true>(data + 1, size - 1, data[0], out, n);
+        ++res.size;
+        return res;
+    }
+
+#ifdef __cpp_lib_span
+    static DecodeResult<std::size_t> decode_binary_batch(std::span<const uint8_t> data, std::span<Decimal> out) noexcept {
+        return decode_binary_batch(data.data(), data.size(), out.data(), out.size());
+    }
+    static std::size_t encode_binary_stream(std::span<const Decimal> values, uint8_t* out) {
+        return encode_binary_stream(values.data(), values.data() + values.size(), out);
+    }
+    static DecodeResult<std::size_t> decode_binary_stream(std::span<const uint8_t> data, std::span<Decimal> out) noexcept {
+        return decode_binary_stream(data.data(), data.size(), out.data(), out.size());
+    }
+#endif
+
+    // decode_binary_data reads from a byte vector, sets the Decimal value, and returns the new offset
+    size_t decode_binary_data(const std::vector<uint8_t>& data, size_t offset = 0) {
+        decode_binary(data, offset);
+        return offset;  // offset has been updated in decode_binary
+    }
+
+    // Longest output of encode_binary: a 7-bit group for every started 7 bits of IntType,
+    // and the places byte.
+    static constexpr std::size_t max_encoded_size = (sizeof(IntType) * 8 + 6) / 7 + 1;
+
+    // encode_binary serializes the Decimal value into a byte vector and updates the offset.
+    // Only the bytes of the value are written, so data past them is kept.
+    void encode_binary(std::vector<uint8_t>& data, size_t& offset) const {
+        uint8_t tmp[max_encoded_size];
+        size_t n = encode_binary(tmp);
+        if (data.size() < offset + n) {
+            data.resize(offset + n);
+        }
+        std::memcpy(data.data() + offset, tmp, n);
+        offset += n;
+    }
+
+    // encode_binary writes the Decimal to out, which must have room for max_encoded_size
+    // bytes, and returns the number of bytes it takes. Bytes past those may be overwritten.
+    std::size_t encode_binary(uint8_t* out) const {
+        uint8_t* p = detail::write_varint(out, to_varint(fp));
+        *p++ = binary_header;
+        return static_cast<std::size_t>(p - out);
+    }
+
+    // encode_binary_batch writes the Decimals in [first, last) back to back to out, which
+    // must have room for max_encoded_size bytes per value, and returns the bytes they take.
+    static std::size_t encode_binary_batch(const Decimal* first, const Decimal* last, uint8_t* out) {
+        uint8_t* p = out;
+        for (; first != last; ++first) {
+            p += first->encode_binary(p);
+        }
+        return static_cast<std::size_t>(p - out);
+    }
+
+#ifdef __cpp_lib_span
+    static std::size_t encode_binary_batch(std::span<const Decimal> values, uint8_t* out) {
+        return encode_binary_batch(values.data(), values.data() + values.size(), out);
+    }
+#endif
+
+    // Overloaded version of encode_binary that creates a new vector
+    [[nodiscard]] std::vector<uint8_t> encode_binary() const {
+        std::vector<uint8_t> data(max_encoded_size);
+        data.resize(encode_binary(data.data()));
+        return data;
+    }
+
+   private:
+    // The integer part of a Decimal must be strictly less than this.
+    static constexpr IntType intLimit = detail::const_pow<10, (digits - nPlaces), IntType>();
+
+    static constexpr bool is_wide = sizeof(IntType) > sizeof(int64_t);
+
+    // The range of IntType itself.
+    static constexpr IntType int_max = static_cast<IntType>(~UIntType(0) >> (detail::is_signed(S) ? 1 : 0));
+    static constexpr IntType int_min = detail::is_signed(S) ? -int_max - 1 : 0;
+
+    // The header byte encode_binary writes after each varint, see kBinaryFormatShift.
+    static constexpr uint8_t binary_header =
+        static_cast<uint8_t>(nPlaces | ((detail::is_signed(S) ? detail::kBinaryZigZag : detail::kBinaryPlain) << detail::kBinaryFormatShift));
+
+    // to_varint returns the value encode_binary writes for fp. ZigZag interleaves signs,
+    // 0, -1, 1, -2, ..., so small negatives stay short.
+    static constexpr UIntType to_varint(IntType v) {
+        if constexpr (detail::is_signed(S)) {
+            return (static_cast<UIntType>(v) << 1) ^ static_cast<UIntType>(v >> (sizeof(IntType) * 8 - 1));
+        } else {
+            return v;
+        }
+    }
+
+    // from_varint returns the fp that to_varint maps to value.
+    static constexpr IntType from_varint(UIntType value) {
+        if constexpr (detail::is_signed(S)) {
+            return static_cast<IntType>((value >> 1) ^ (UIntType(0) - (value & 1)));
+        } else {
+            return value;
+        }
+    }
+
+    // read_varint reads the varint at data[i] into value and moves i past it. It returns
+    // std::errc::invalid_argument if the bytes end first and std::errc::result_out_of_range
+    // if it is longer than IntType.
+    static std::errc read_varint(const uint8_t* data, std::size_t size, std::size_t& i, UIntType& value) noexcept {
+        constexpr int bits = sizeof(IntType) * 8;
+        value = 0;
+        for (int shift = 0;; shift += 7) {
+            if (unlikely(i == size)) {
+                return std::errc::invalid_argument;
+            }
+            uint8_t byte = data[i++];
+            UIntType payload = byte & 0x7F;
+            if (unlikely(shift > bits - 7 && (shift >= bits || payload >> (bits - shift) != 0))) {
+                return std::errc::result_out_of_range;
+            }
+            value |= payload << shift;
+            if ((byte & 0x80) == 0) {
+                return {};
+            }
+        }
+    }
+
+    // decode_varints decodes up to n values at data into out, each a varint followed by its
+    // header byte, or with shared all varints using header. Movemasks find where every
+    // varint in a 64 byte window ends; those of up to 9 bytes are then read without a branch
+    // per byte. The rest, and the last bytes, go through read_varint.
+    template <bool shared>
+    static DecodeResult<std::size_t> decode_varints(const uint8_t* data, std::size_t size, uint8_t header, Decimal* out, std::size_t n) noexcept {
+        constexpr unsigned trailer = shared ? 0 : 1;
+        std::size_t i = 0, k = 0;
+        while (k < n && i < size) {
+#ifdef DECIMAL_SIMD_VARINT
+            if (!is_wide && i + detail::kVarintWindow + 8 <= size) {
+                uint64_t ends = detail::varint_ends(data + i);
+                std::size_t start = k;
+                unsigned pos = 0;
+                // Each end bit is consumed with a clear-lowest-bit, so len comes from ctz alone.
+                while (k < n && ends != 0) {
+                    unsigned last = static_cast<unsigned>(__builtin_ctzll(ends));
+                    unsigned len = last + 1 - pos;
+                    if (len > 9) {
+                        break;
+                    }
+                    ends &= ends - 1;
+                    if constexpr (!shared) {
+                        // The header must be the next byte and end within the window.
+                        if (last == detail::kVarintWindow - 1 || (ends & (uint64_t(1) << (last + 1))) == 0) {
+                            break;
+                        }
+                        header = data[i + last + 1];
+                        ends &= ends - 1;
+                    }
+                    auto value = static_cast<UIntType>(detail::read_varint9(data + i + pos, len));
+                    // Values written by this type need no rescaling, only the sign undone.
+                    if (likely(header == binary_header && value <= to_varint(max_fp))) {
+                        out[k].fp = from_varint(value);
+                    } else {
+                        std::errc ec = from_varint(value, header, out[k].fp);
+                        if (unlikely(ec != std::errc())) {
+                            return {k, i + pos, ec};
+                        }
+                    }
+                    ++k;
+                    pos = last + 1 + trailer;
+                }
+                i += pos;
+                if (likely(k != start)) {
+                    continue;
+                }
+            }
+#endif
+            std::size_t next = i;
+            UIntType value;
+            std::errc ec = read_varint(data, size, next, value);
+            if (!shared && ec == std::errc() && unlikely(next == size)) {
+                ec = std::errc::invalid_argument;
+            }
+            if (unlikely(ec != std::errc())) {
+                return {k, i, ec};
+            }
+            if constexpr (!shared) {
+                header = data[next++];
+            }
+            ec = from_varint(value, header, out[k].fp);
+            if (unlikely(ec != std::errc())) {
+                return {k, i, ec};
+            }
+            ++k;
+            i = next;
+        }
+        return {k, i, std::errc()};
+    }
+
+    // from_varint stores the value of a varint read by decode_binary in out, given the header
+    // byte that followed it, and returns std::errc(), or returns std::errc::invalid_argument
+    // for an unknown format and std::errc::result_out_of_range if the value does not fit.
+    static std::errc from_varint(UIntType value, uint8_t header, IntType& out) noexcept {
+        bool negative = false;
+        switch (header >> detail::kBinaryFormatShift) {
+            case detail::kBinaryPlain:
+                break;
+            case detail::kBinaryZigZag:
+                negative = (value & 1) != 0;
+                value = (value >> 1) + (value & 1);
+                break;
+            default:
+                return std::errc::invalid_argument;
+        }
+
+        // Wrap and Unchecked values may use all of IntType, the others stay within max_fp.
+        constexpr bool full = P == Overflow::Wrap || P == Overflow::Unchecked;
+        UIntType limit = full ? static_cast<UIntType>(int_max) + negative : static_cast<UIntType>(max_fp);
+        if constexpr (!detail::is_signed(S)) {
+            limit = negative ? 0 : limit;
+        }
+
+        int places = header & detail::kBinaryPlacesMask;
+        if (unlikely(places > nPlaces)) {
+            value = places - nPlaces > digits ? 0 : value / detail::precomputed_pow_10<UIntType>(places - nPlaces);
+        } else if (unlikely(places < nPlaces)) {
+            UIntType factor = detail::precomputed_pow_10<UIntType>(nPlaces - places);
+            if (unlikely(value > limit / factor)) {
+                return std::errc::result_out_of_range;
+            }
+            value *= factor;
+        }
+        if (unlikely(value > limit)) {
+            return std::errc::result_out_of_range;
+        }
+        out = static_cast<IntType>(negative ? UIntType(0) - value : value);
+        return {};
+    }
+
+    // from_double stores f rounded like Decimal(double) in out and returns std::errc(), or
+    // returns std::errc::invalid_argument for NaN and std::errc::result_out_of_range if it
+    // does not fit, leaving out untouched. See kDoubleMargin for the fast path; anything
+    // else reads back the shortest decimal for f.
+    static std::errc from_double(double f, IntType& out) {
+        if constexpr (nPlaces <= 22) {
+            double y = f * static_cast<double>(scale);
+            double a = y < 0 ? -y : y;
+            if (likely(a < 0x1p50 && (detail::is_signed(S) || !(y < 0)))) {
+                // q is y rounded either way depending on the rounding mode, but when it is
+                // clearly within half a unit it is the nearest one whatever the mode.
+                long long q = detail::round_int64(y);
+                if (likely(0.5 - std::abs(y - static_cast<double>(q)) > a * detail::kDoubleMargin)) {
+                    out = static_cast<IntType>(q);
+                    return {};
+                }
+            }
+        }
+        return from_double_digits(f, out);
+    }
+
+    // from_double_digits is the slow, exact path of from_double, split out so the fast
+    // path stays small enough to inline into loops.
+    static std::errc from_double_digits(double f, IntType& out) {
+        if (unlikely(!std::isfinite(f))) {
+            return std::isnan(f) ? std::errc::invalid_argument : std::errc::result_out_of_range;
+        }
+        char buf[32];
+        char* end = detail::shortest_chars(buf, buf + sizeof(buf), f);
+        return parse(buf, end, out).ec;
+    }
+
+    // to_double_digits is the slow, exact path of to_double, for values too large for a
+    // double to hold fp exactly.
+    double to_double_digits() const {
+        char buf[64];
+        char* last = buf + sizeof(buf) - 1;
+        *last = '\0';
+        char* first = detail::write_digits(last, static_cast<uint64_t>(nPlaces));
+        *--first = '-';
+        *--first = 'e';
+        first = detail::write_digits(first, magnitude(fp));
+        if (is_negative(fp)) {
+            *--first = '-';
+        }
+        return detail::read_double(first, last);
+    }
+
+    // parse reads the longest decimal prefix of [first, last) into out. On failure out
+    // is left untouched and the error is reported std::from_chars style.
+    static constexpr std::from_chars_result parse(const char* first, const char* last, IntType& out) {
+        const char* p = first;
+        bool negative = false;
+        if (p != last && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            ++p;
+        }
+
+        const char* int_begin = p;
+        IntType i = 0;
+        bool too_large = false;
+        for (; p != last && detail::is_digit(*p); ++p) {
+            if (likely(!too_large)) {
+                i = i * 10 + (*p - '0');
+                too_large = i >= intLimit;
+            }
+        }
+        bool has_digits = p != int_begin;
+
+        IntType f = 0;
+        if (p != last && *p == '.') {
+            const char* frac_begin = p + 1;
+            const char* q = frac_begin;
+            int n = 0;
+            for (; q != last && detail::is_digit(*q); ++q) {
+                if (n < nPlaces) {
+                    f = f * 10 + (*q - '0');
+                    ++n;
+                }
+            }
+            if (has_digits || q != frac_begin) {
+                has_digits = true;
+                p = q;
+                f *= detail::precomputed_pow_10<IntType>(nPlaces - n);
+            }
+        }
+
+        if (unlikely(!has_digits)) {
+            return {first, std::errc::invalid_argument};
+        }
+
+        if (p != last && (*p == 'e' || *p == 'E')) {
+            int exp = 0;
+            const char* exp_end = parseExponent(p + 1, last, exp);
+            if (exp_end != p + 1) {
+                return parseScientific(int_begin, p, exp, negative, exp_end, out);
+            }
+        }
+
+        if (unlikely(too_large)) {
+            return {p, std::errc::result_out_of_range};
+        }
+
+        IntType value = i * scale + f;
+        if (negative) {
+            if constexpr (detail::is_signed(S)) {
+                value = -value;
+            } else if (unlikely(value != 0)) {
+                return {p, std::errc::result_out_of_range};
+            }
+        }
+
+        out = value;
+        return {p, std::errc()};
+    }
+
+    // parseFixed is the parse_batch fast path for an optionally negative field of digits
+    // with at most one point. It returns false, leaving out untouched, for anything else.
+    static bool parseFixed(const char* p, std::size_t n, IntType& out) {
+#ifdef DECIMAL_FIXED_PARSE
+        bool negative = false;
+        if constexpr (detail::is_signed(S)) {
+            if (n != 0 && *p == '-') {
+                negative = true;
+                ++p;
+                --n;
+            }
+        }
+
+        if (n == 0 || n > 16) {
+            return false;
+        }
+
+        uint64_t value = 0;
+        std::size_t int_len = 0, frac_len = 0;
+        if (!detail::parse_fixed_digits(p, n, value, int_len, frac_len)) {
+            return false;
+        }
+
+        constexpr auto max_int_len = static_cast<std::size_t>(digits - nPlaces);
+        constexpr auto max_frac_len = static_cast<std::size_t>(nPlaces);
+        if (int_len > max_int_len || frac_len > max_frac_len || int_len + frac_len == 0) {
+            return false;
+        }
+
+        auto m = static_cast<UIntType>(value) * detail::precomputed_pow_10<UIntType>(nPlaces - frac_len);
+        out = negative ? static_cast<IntType>(0 - m) : static_cast<IntType>(m);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // parseExponent reads an optionally signed exponent starting at p and returns the
+    // end of it, or p if there is none. Very large exponents saturate.
+    static constexpr const char* parseExponent(const char* p, const char* last, int& exp) {
+        const char* begin = p;
+        bool negative = false;
+        if (p != last && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            ++p;
+        }
+
+        const char* digits_begin = p;
+        for (; p != last && detail::is_digit(*p); ++p) {
+            if (exp < 100000) {
+                exp = exp * 10 + (*p - '0');
+            }
+        }
+        if (p == digits_begin) {
+            return begin;
+        }
+
+        if (negative) {
+            exp = -exp;
+        }
+        return p;
+    }
+
+    // parseScientific computes the value of the digits in [begin, end) times 10^exp
+    // exactly, rounding half away from zero at the nth place like newI.
+    static constexpr std::from_chars_result parseScientific(const char* begin, const char* end, int exp, bool negative,
+                                                            const char* ptr, IntType& out) {
+        constexpr int max_digits = is_wide ? 38 : std::numeric_limits<uint64_t>::digits10;
+        constexpr auto limit = detail::const_pow<10, digits, UIntType>();
+
+        UIntType m = 0;
+        int sig_digits = 0;
+        int round_digit = 0;
+        bool seen_point = false;
+        bool truncated = false;
+        for (const char* q = begin; q != end; ++q) {
+            if (*q == '.') {
+                seen_point = true;
+                continue;
+            }
+
+            int d = *q - '0';
+            if (sig_digits < max_digits) {
+                if (m != 0 || d != 0) {
+                    m = m * 10 + d;
+                    ++sig_digits;
+                }
+                if (seen_point) {
+                    --exp;
+                }
+            } else {
+                if (!truncated) {
+                    round_digit = d;
+                    truncated = true;
+                }
+                if (!seen_point) {
+                    ++exp;
+                }
+            }
+        }
+
+        int shift = exp + nPlaces;
+        if (shift >= 0) {
+            if (truncated && shift == 0 && round_digit >= 5) {
+                ++m;  // rounding factor
+            }
+            if (m != 0) {
+                if (unlikely(shift > digits || m >= limit / detail::precomputed_pow_10<UIntType>(shift))) {
+                    return {ptr, std::errc::result_out_of_range};
+                }
+                m *= detail::precomputed_pow_10<UIntType>(shift);
+            }
+        } else if (-shift > max_digits) {
+            m = 0;
+        } else {
+            UIntType pow = detail::precomputed_pow_10<UIntType>(-shift);
+            UIntType q = div_pow10(m, -shift);
+            UIntType rem = m - q * pow;
+            m = q;
+            if (rem >= pow - rem) {
+                ++m;  // rounding factor
+            }
+        }
+
+        if (unlikely(m >= limit)) {
+            return {ptr, std::errc::result_out_of_range};
+        }
+
+        auto value = static_cast<IntType>(m);
+        if (negative) {
+            if constexpr (detail::is_signed(S)) {
+                value = -value;
+            } else if (unlikely(value != 0)) {
+                return {ptr, std::errc::result_out_of_range};
+            }
+        }
+
+        out = value;
+        return {ptr, std::errc()};
+    }
+
+    template <int, Type, Overflow>
+    friend class Decimal;
+
+    template <int N, Type T, Overflow Q>
+    friend constexpr std::from_chars_result from_chars(const char* first, const char* last, Decimal<N, T, Q>& value);
+
+    template <Rounding R, int N, Type T, Overflow Q>
+    friend constexpr Decimal<N, T, Q> fma(const Decimal<N, T, Q>& a, const Decimal<N, T, Q>& b, const Decimal<N, T, Q>& c);
+
+    template <Rounding R, int A, int B, Type T, Overflow Q>
+    friend constexpr Decimal<(A > B ? A : B), T, Q> dot(const Decimal<A, T, Q>* a, const Decimal<B, T, Q>* b, std::size_t n);
+
+    template <Rounding R = Rounding::Truncate>
+    static constexpr IntType mul(IntType fp, IntType f0) {
+        if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+            return wrapping_mul<R>(fp, f0);
+        } else {
+            IntType out = 0;
+            if (unlikely(!try_mul<R>(fp, f0, out))) {
+                return overflowed(is_negative(fp) != is_negative(f0));
+            }
+            return out;
+        }
+    }
+
+    // wrapping_mul returns the rounded quotient fp * f0 / scale modulo 2^64 (2^128 when
+    // wide). Unchecked skips the slow path for quotients that do not fit, leaving the
+    // result unspecified.
+    template <Rounding R>
+    static constexpr IntType wrapping_mul(IntType fp, IntType f0) {
+        UIntType a = magnitude(fp);
+        UIntType b = magnitude(f0);
+        bool neg = is_negative(fp) != is_negative(f0);
+        constexpr auto d = static_cast<UIntType>(scale);
+
+        UIntType q = 0, rem = 0;
+        if constexpr (is_wide) {
+            UIntType hi = 0, lo = 0;
+            detail::mul_256(a, b, hi, lo);
+            q = div_scale(P == Overflow::Unchecked || likely(hi < d) ? hi : hi % d, lo, rem);
+        } else {
+            auto wide = static_cast<unsigned __int128>(a) * b;
+            if (P == Overflow::Unchecked || likely(static_cast<uint64_t>(wide >> 64) < d)) {
+                q = detail::div_wide<d>(wide, rem);
+            } else {
+                auto q128 = wide / d;
+                rem = static_cast<uint64_t>(wide - q128 * d);
+                q = static_cast<uint64_t>(q128);
+            }
+        }
+        return with_sign(detail::round_quotient<R>(q, rem, d, neg), neg);
+    }
+
+    // try_mul stores fp * f0 / scale rounded according to R in out, or returns false if it
+    // is out of range. The exact product always fits in twice the bits of IntType.
+    template <Rounding R>
+    static constexpr bool try_mul(IntType fp, IntType f0, IntType& out) {
+        UIntType a = magnitude(fp);
+        UIntType b = magnitude(f0);
+        bool neg = is_negative(fp) != is_negative(f0);
+        constexpr auto d = static_cast<UIntType>(scale);
+
+        UIntType q = 0, rem = 0;
+        if constexpr (is_wide) {
+            UIntType hi = 0, lo = 0;
+            detail::mul_256(a, b, hi, lo);
+            if (unlikely(hi >= d)) {
+                return false;
+            }
+            q = div_scale(hi, lo, rem);
+        } else {
+            auto wide = static_cast<unsigned __int128>(a) * b;
+            if (unlikely(static_cast<uint64_t>(wide >> 64) >= d)) {
+                return false;
+            }
+            q = detail::div_wide<d>(wide, rem);
+        }
+        if (unlikely(q > static_cast<UIntType>(max_fp))) {
+            return false;
+        }
+        q = detail::round_quotient<R>(q, rem, d, neg);
+        if (unlikely(q > static_cast<UIntType>(max_fp))) {
+            return false;
+        }
+        out = with_sign(q, neg);
+        return true;
+    }
+
+    // rescaled_mul returns a * b, whose exact value has fromPlaces places, rounded to
+    // nPlaces according to R.
+    template <Rounding R, int fromPlaces>
+    static constexpr IntType rescaled_mul(IntType a, IntType b) {
+        bool neg = is_negative(a) != is_negative(b);
+
+        unsigned __int128 hi = 0, lo = 0;
+        if constexpr (is_wide) {
+            detail::mul_256(magnitude(a), magnitude(b), hi, lo);
+        } else {
+            lo = static_cast<unsigned __int128>(magnitude(a)) * magnitude(b);
+        }
+        return rescale<R, fromPlaces - nPlaces>(hi, lo, neg);
+    }
+
+    // rescale returns the magnitude hi * 2^128 + lo, which has nPlaces + shift places,
+    // rounded to nPlaces according to R.
+    template <Rounding R, int shift>
+    static constexpr IntType rescale(unsigned __int128 hi, unsigned __int128 lo, bool neg) {
+        UIntType q = 0;
+        bool fits = rescale_magnitude<R, shift>(hi, lo, neg, q);
+        if constexpr (P == Overflow::Throw || P == Overflow::Saturate) {
+            if (unlikely(!fits)) {
+                return overflowed(neg);
+            }
+        }
+        return with_sign(q, neg);
+    }
+
+    // rescale_magnitude stores rescale's rounded magnitude in q and returns whether it is
+    // within max_fp.
+    template <Rounding R, int shift>
+    static constexpr bool rescale_magnitude(unsigned __int128 hi, unsigned __int128 lo, bool neg, UIntType& q) {
+        if constexpr (shift <= 0) {
+            constexpr auto pow = detail::const_pow<10, -shift, UIntType>();
+            bool fits = hi == 0 && lo <= static_cast<UIntType>(max_fp) / pow;
+            q = static_cast<UIntType>(lo) * pow;
+            return round_rescaled<R>(q, 0, 1, neg, fits);
+        } else if constexpr (!is_wide && shift <= 19) {
+            // The usual case, a quotient that fits, is one division by a constant, and one
+            // of 64 bits when the magnitude is that small.
+            constexpr auto pow = detail::const_pow<10, shift>();
+            if (likely(hi == 0 && (lo >> 64) == 0)) {
+                auto m = static_cast<uint64_t>(lo);
+                q = m / pow;
+                return round_rescaled<R>(q, m - q * pow, pow, neg, true);
+            }
+            if (likely(hi == 0 && static_cast<uint64_t>(lo >> 64) < pow)) {
+                uint64_t rem = 0;
+                q = detail::div_wide<pow>(lo, rem);
+                return round_rescaled<R>(q, rem, pow, neg, true);
+            }
+        } else if constexpr (is_wide && shift == nPlaces) {
+            // Wide products and fma sums are rescaled by scale, one 256-bit division.
+            if (likely(hi < static_cast<UIntType>(scale))) {
+                UIntType rem = 0;
+                q = detail::div_256(hi, lo, static_cast<UIntType>(scale), rem);
+                return round_rescaled<R>(q, rem, static_cast<UIntType>(scale), neg, true);
+            }
+        }
+        uint64_t rem = 0, d = 0;
+        detail::div_pow10_256(hi, lo, shift, rem, d);
+        bool fits = hi == 0 && (is_wide || (lo >> 64) == 0);
+        q = static_cast<UIntType>(lo);
+        return round_rescaled<R>(q, rem, d, neg, fits);
+    }
+
+    // rescaled_sum returns an exact sum of products with nPlaces + shift places, rounded
+    // to nPlaces according to R.
+    template <Rounding R, int shift>
+    static constexpr IntType rescaled_sum(const detail::ProductSum<S>& sum) {
+        unsigned __int128 hi = 0, lo = 0;
+        bool neg = sum.magnitude(hi, lo);
+        if constexpr (P == Overflow::Throw || P == Overflow::Saturate) {
+            if (unlikely(sum.overflow)) {
+                return overflowed(!neg);
+            }
+        }
+        return rescale<R, shift>(hi, lo, neg);
+    }
+
+    // try_rescaled_sum stores rescaled_sum in out, or returns false if it is out of range,
+    // whatever P.
+    template <Rounding R, int shift>
+    static constexpr bool try_rescaled_sum(const detail::ProductSum<S>& sum, IntType& out) {
+        unsigned __int128 hi = 0, lo = 0;
+        bool neg = sum.magnitude(hi, lo);
+        UIntType q = 0;
+        if (unlikely((sum.overflow || !rescale_magnitude<R, shift>(hi, lo, neg, q)))) {
+            return false;
+        }
+        out = with_sign(q, neg);
+        return true;
+    }
+
+    // rescaled_div returns a * 10^e / b rounded according to R.
+    template <Rounding R, int e>
+    static constexpr IntType rescaled_div(IntType a, IntType b) {
+        if (unlikely(b == 0)) {
+            throw errDivByZero;
+        }
+
+        UIntType ma = magnitude(a);
+        UIntType mb = magnitude(b);
+        bool neg = is_negative(a) != is_negative(b);
+
+        UIntType q = 0, rem = 0, d = mb;
+        bool fits = true;
+        if constexpr (e >= 0) {
+            static_assert(e <= 76, "the rescale does not fit in 256 bits");
+            if constexpr (!is_wide && e <= 19) {
+                auto num = static_cast<unsigned __int128>(ma) * detail::const_pow<10, e>();
+                if (likely(static_cast<uint64_t>(num >> 64) < mb)) {
+                    q = detail::div_128(num, mb, rem);
+                } else {
+                    fits = false;
+                    auto q128 = num / mb;
+                    rem = static_cast<uint64_t>(num - q128 * mb);
+                    q = static_cast<uint64_t>(q128);
+                }
+            } else {
+                // Past 10^38 the dividend is scaled in two steps, with top holding the bits
+                // past 256, and the quotient is taken a 128-bit limb at a time.
+                unsigned __int128 top = 0, hi = 0, lo = 0, r = 0;
+                detail::mul_256(ma, detail::const_pow<10, (e > 38 ? 38 : e), unsigned __int128>(), hi, lo);
+                if constexpr (e > 38) {
+                    unsigned __int128 carry = 0;
+                    detail::mul_256(lo, detail::const_pow<10, e - 38, unsigned __int128>(), carry, lo);
+                    detail::mul_256(hi, detail::const_pow<10, e - 38, unsigned __int128>(), top, hi);
+                    hi += carry;
+                    top += hi < carry ? 1 : 0;
+                }
+                fits = top == 0 && hi < mb;
+                if (unlikely(!fits)) {
+                    detail::div_256(top % mb, hi, mb, r);
+                    hi = r;
+                }
+                auto q128 = detail::div_256(hi, lo, mb, r);
+                fits = fits && (is_wide || (q128 >> 64) == 0);
+                q = static_cast<UIntType>(q128);
+                rem = static_cast<UIntType>(r);
+            }
+        } else {
+            // Divide exactly, then drop -e digits the way div_pow10_256 does.
+            constexpr auto pow = detail::const_pow<10, -e, UIntType>();
+            UIntType whole = ma / mb;
+            q = whole / pow;
+            rem = 2 * (whole - q * pow) + (whole * mb != ma ? 1 : 0);
+            d = 2 * pow;
+        }
+        return rescaled_result<R>(q, rem, d, neg, fits);
+    }
+
+    // rescaled_result rounds the magnitude q of a rescaled product or quotient, given the
+    // remainder of a division by d, and applies P if it is out of range.
+    template <Rounding R>
+    static constexpr IntType rescaled_result(UIntType q, UIntType rem, UIntType d, bool neg, bool fits) {
+        fits = round_rescaled<R>(q, rem, d, neg, fits);
+        if constexpr (P == Overflow::Throw || P == Overflow::Saturate) {
+            if (unlikely(!fits)) {
+                return overflowed(neg);
+            }
+        }
+        return with_sign(q, neg);
+    }
+
+    // round_rescaled rounds q as rescaled_result does, in place, and returns whether the
+    // result is within max_fp.
+    template <Rounding R>
+    static constexpr bool round_rescaled(UIntType& q, UIntType rem, UIntType d, bool neg, bool fits) {
+        fits = fits && q <= static_cast<UIntType>(max_fp);
+        q = detail::round_quotient<R>(q, rem, d, neg);
+        return fits && q <= static_cast<UIntType>(max_fp);
+    }
+
+    // div_scale returns (hi * 2^128 + lo) / scale for a wide Decimal and stores the
+    // remainder in rem, where hi < scale. Scales that fit in 64 bits use div_wide.
+    static constexpr UIntType div_scale(UIntType hi, UIntType lo, UIntType& rem) {
+        if constexpr (nPlaces <= 19) {
+            constexpr auto d = static_cast<uint64_t>(scale);
+            uint64_t r = 0;
+            uint64_t q1 = detail::div_wide<d>((hi << 64) | static_cast<uint64_t>(lo >> 64), r);
+            uint64_t q0 = detail::div_wide<d>((static_cast<UIntType>(r) << 64) | static_cast<uint64_t>(lo), r);
+            rem = r;
+            return (static_cast<UIntType>(q1) << 64) | q0;
+        } else {
+            return detail::div_256(hi, lo, static_cast<UIntType>(scale), rem);
+        }
+    }
 
-    // Creates a Decimal from a double, rounding at the nth place
-    Decimal(double f) {
-        if (unlikely(std::isnan(f))) {
-            throw errInvalidInput;
+    // div_pow10 returns m / 10^n for n in [1, 19], or up to 38 when wide.
+    static constexpr UIntType div_pow10(UIntType m, unsigned int n) {
+        if constexpr (is_wide) {
+            return m / detail::precomputed_pow_10<UIntType>(n);
+        } else {
+            return detail::div_pow10(m, n);
         }
+    }
 
-        double round = 0.5;
+    // magnitude returns |v|, which is exact even for the most negative v.
+    static constexpr UIntType magnitude(IntType v) {
+        if constexpr (detail::is_signed(S)) {
+            return v < 0 ? 0 - static_cast<UIntType>(v) : static_cast<UIntType>(v);
+        } else {
+            return v;
+        }
+    }
 
-        if (S == Signed) {
-            if (unlikely(f >= MAX || f <= MIN)) {
-                throw errOverflow;
-            }
+    // overflowed is the result of an operation whose exact value is past min_fp when neg
+    // is set, or max_fp otherwise: Throw throws and Saturate clamps.
+    static constexpr IntType overflowed(bool neg) {
+        if constexpr (P == Overflow::Throw) {
+            throw errOverflow;
+        } else {
+            return neg ? min_fp : max_fp;
+        }
+    }
 
-            if (f < 0) {
-                round = -0.5;
-            }
+    // sum_negative and difference_negative tell whether the exact a + b or a - b is
+    // negative, without computing a result that may not fit.
+    static constexpr bool sum_negative(IntType a, IntType b) {
+        if constexpr (detail::is_signed(S)) {
+            return is_negative(a) == is_negative(b) ? is_negative(a) : a + b < 0;
         } else {
-            if (unlikely(f >= MAX || f < 0)) {
-                throw errOverflow;
-            }
+            return false;
         }
+    }
 
-        fp = static_cast<IntType>(f * scale + round);
+    static constexpr bool difference_negative(IntType a, IntType b) {
+        if constexpr (detail::is_signed(S)) {
+            return is_negative(a) != is_negative(b) ? is_negative(a) : a - b < 0;
+        } else {
+            return a < b;
+        }
     }
 
-    // Creates a Decimal for an integer, moving the decimal point n places to the left
-    // For example, Decimal(123,1) becomes 12.3. If n > 7, the value is truncated
-    Decimal(IntType i, uint32_t n) { fp = newI(i, n); }
-
-    Decimal(const std::string& s) {
-        // TODO: optimize string parsing algorithm
-        if (s.find_first_of("eE") != std::string::npos) {
-            double f = std::stod(s);
-            fp = static_cast<IntType>(f * scale);
-            return;
-        }
-
-        std::size_t period = s.find('.');
-        IntType i = 0, f = 0;
-        if (period == std::string::npos) {
-            i = parseInteger(s);
-            if constexpr (S == Signed) {
-                if (i > 0 && unlikely(i > MAX)) {
-                    throw errTooLarge;
-                } else if (i < 0 && unlikely(-i > MAX)) {
-                    throw errTooLarge;
-                }
-            } else {
-                if (unlikely(i > MAX)) {
-                    throw errTooLarge;
-                }
-            }
-            fp = i * scale;
+    static constexpr bool is_negative(IntType v) {
+        if constexpr (detail::is_signed(S)) {
+            return v < 0;
         } else {
-            bool negative = false;
-            if (period > 0) {
-                if constexpr (S == Signed) {
-                    if (s[0] == '-') {
-                        negative = true;
-                    }
+            return false;
+        }
+    }
 
-                    if (negative && period == 1) {
-                        i = 0;
-                    } else {
-                        i = parseInteger(s.substr(0, period));
-                        if (i > 0 && unlikely(i > MAX)) {
-                            throw errTooLarge;
-                        } else if (i < 0 && unlikely(-i > MAX)) {
-                            throw errTooLarge;
-                        }
-                    }
-                } else {
-                    i = parseInteger(s.substr(0, period));
-                    if (unlikely(i > MAX)) {
-                        throw errTooLarge;
-                    }
-                }
+    static constexpr IntType with_sign(UIntType m, bool neg) { return static_cast<IntType>(neg ? 0 - m : m); }
+
+    using DivT = typename std::conditional<detail::has_int128, IntType, double>::type;
+
+    static constexpr DivT div(IntType fp, IntType f0) {
+        if constexpr (!detail::has_int128) {
+            if (unlikely(f0 == 0)) {
+                throw errDivByZero;
             }
-            std::string fs = s.substr(period + 1);
-            fs += std::string(max(0, static_cast<int>(nPlaces - fs.length())), '0');
-            f = parseInteger(fs.substr(0, nPlaces));
-            if (i < 0 || negative) {
-                fp = i * scale - f;
-            } else {
-                fp = i * scale + f;
+            return double(fp) / double(f0);
+        } else if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+            return wrapping_div(fp, f0);
+        } else {
+            IntType out = 0;
+            auto ec = try_div(fp, f0, out);
+            if (unlikely(ec != std::errc())) {
+                if (ec == std::errc::argument_out_of_domain) {
+                    throw errDivByZero;
+                }
+                return overflowed(is_negative(fp) != is_negative(f0));
             }
+            return out;
         }
     }
 
-    // New returns a new fixed-point decimal, value * 10 ^ exp.
-    static Decimal FromExp(IntType value, int exp) {
-        if (exp >= 0) {
-            auto exp_mul = detail::precomputed_pow_10<IntType>(exp);
-            return {mul(newI(value, 0), newI(exp_mul, 0))};
+    // wrapping_div returns fp * scale / f0, rounded half away from zero, modulo 2^64
+    // (2^128 when wide). Unchecked shares it, as a quotient that does not fit would fault
+    // in divq.
+    static constexpr IntType wrapping_div(IntType fp, IntType f0) {
+        if (unlikely(f0 == 0)) {
+            throw errDivByZero;
         }
 
-        return {newI(value, static_cast<unsigned int>(-exp))};
+        UIntType a = magnitude(fp);
+        UIntType b = magnitude(f0);
+        bool neg = is_negative(fp) != is_negative(f0);
+
+        UIntType q = 0, rem = 0;
+        if constexpr (is_wide) {
+            UIntType hi = 0, lo = 0;
+            detail::mul_256(a, static_cast<UIntType>(scale), hi, lo);
+            q = detail::div_256(likely(hi < b) ? hi : hi % b, lo, b, rem);
+        } else {
+            auto num = static_cast<unsigned __int128>(a) * scale;
+            if (likely(static_cast<uint64_t>(num >> 64) < b)) {
+                q = detail::div_128(num, b, rem);
+            } else {
+                auto q128 = num / b;
+                rem = static_cast<uint64_t>(num - q128 * b);
+                q = static_cast<uint64_t>(q128);
+            }
+        }
+        if (rem >= b - rem) {
+            ++q;  // rounding factor
+        }
+        return with_sign(q, neg);
     }
 
-    [[nodiscard]] bool is_zero() const { return fp == 0; }
+    // try_div stores fp * scale / f0, rounded half away from zero, in out.
+    static constexpr std::errc try_div(IntType fp, IntType f0, IntType& out) {
+        if (unlikely(f0 == 0)) {
+            return std::errc::argument_out_of_domain;
+        }
 
-    // Float converts the Decimal to a float64
-    [[nodiscard]] double to_double() const { return static_cast<double>(fp) / scale; }
+        UIntType a = magnitude(fp);
+        UIntType b = magnitude(f0);
+        bool neg = is_negative(fp) != is_negative(f0);
 
-    // Add adds f0 to f producing a Decimal.
-    Decimal operator+(const Decimal& f0) const {
-        if constexpr (S == Signed) {
-            if (unlikely(fp > 0 && f0.fp > 0 && fp > MAX - f0.fp)) {
-                throw errOverflow;
-            }
-            if (unlikely(fp < 0 && f0.fp < 0 && fp < MIN - f0.fp)) {
-                throw errOverflow;
+        UIntType q = 0, rem = 0;
+        if constexpr (is_wide) {
+            UIntType hi = 0, lo = 0;
+            detail::mul_256(a, static_cast<UIntType>(scale), hi, lo);
+            if (unlikely(hi >= b)) {
+                return std::errc::result_out_of_range;
             }
-            IntType sum = fp + f0.fp;
-            return {sum};
+            q = detail::div_256(hi, lo, b, rem);
         } else {
-            if (unlikely(f0.fp > MAX - fp)) {
-                throw errOverflow;
+            auto num = static_cast<unsigned __int128>(a) * scale;
+            if (unlikely(static_cast<uint64_t>(num >> 64) >= b)) {
+                return std::errc::result_out_of_range;
             }
-            return {fp + f0.fp};
+            q = detail::div_128(num, b, rem);
         }
+        if (rem >= b - rem) {
+            ++q;  // rounding factor
+        }
+        if (unlikely(q > static_cast<UIntType>(max_fp))) {
+            return std::errc::result_out_of_range;
+        }
+        out = with_sign(q, neg);
+        return {};
     }
 
-    // Adds f0 to the current Decimal object.
-    Decimal& operator+=(const Decimal& f0) {
-        if (unlikely(f0.fp > UINT64_MAX - fp)) {
-            throw errOverflow;
+    static constexpr IntType newI(IntType i, uint32_t n) {
+        if (n > nPlaces) {
+            unsigned int places = n - nPlaces;
+            auto pow = static_cast<UIntType>(detail::precomputed_pow_10<IntType>(places));
+            UIntType m = magnitude(i);
+            UIntType q = div_pow10(m, places);
+            if (m - q * pow >= pow - pow / 2) {
+                ++q;  // rounding factor
+            }
+            i = with_sign(q, is_negative(i));
+            n = nPlaces;
         }
-        fp += f0.fp;
-        return *this;
+        i *= detail::precomputed_pow_10<IntType>(nPlaces - n);
+        return i;
     }
 
-    // Sub subtracts f0 from f producing a Decimal.
-    Decimal operator-(const Decimal& f0) const {
-        if constexpr (S == Signed) {
-            if (unlikely(fp > 0 && f0.fp < 0 && fp - f0.fp > MAX)) {
-                throw errOverflow;
-            }
-            if (unlikely(fp < 0 && f0.fp > 0 && fp - f0.fp < MIN)) {
-                throw errOverflow;
+    // format writes the Decimal backwards ending at end, always with nPlaces fraction
+    // digits, and returns a pointer to the first character.
+    char* format(char* end) const {
+        auto val = static_cast<UIntType>(fp);
+        if constexpr (detail::is_signed(S)) {
+            if (fp < 0) {
+                val = 0 - val;
             }
-            return {fp - f0.fp};
-        } else {
-            if (unlikely(fp < f0.fp)) {
-                throw errOverflow;
+        }
+
+        constexpr auto uscale = static_cast<UIntType>(scale);
+        using FracT = std::conditional_t<(nPlaces <= 9), uint32_t, std::conditional_t<(nPlaces <= 19), uint64_t, UIntType>>;
+        char* p = detail::write_digits(end, static_cast<FracT>(val % uscale), nPlaces);
+        *--p = '.';
+        p = detail::write_digits(p, val / uscale);
+
+        if constexpr (detail::is_signed(S)) {
+            if (fp < 0) {
+                *--p = '-';
             }
-            return {fp - f0.fp};
         }
+
+        return p;
     }
 
-    // Subtracts f0 from the current Decimal object.
-    Decimal& operator-=(const Decimal& f0) {
-        if (unlikely(fp < f0.fp)) {
-            throw errOverflow;
+    static std::to_chars_result copyChars(const char* begin, const char* end, char* first, char* last) {
+        auto n = end - begin;
+        if (unlikely(last - first < n)) {
+            return {last, std::errc::value_too_large};
         }
-        fp -= f0.fp;
-        return *this;
+        std::memcpy(first, begin, n);
+        return {first + n, std::errc()};
     }
+};
 
-    Decimal operator*(const Decimal& f0) { return {mul(fp, f0.fp)}; }
+template <int nPlaces, Type S, Overflow P>
+const std::runtime_error Decimal<nPlaces, S, P>::errDivByZero("division by zero");
+template <int nPlaces, Type S, Overflow P>
+const std::overflow_error Decimal<nPlaces, S, P>::errTooLarge("number is too large");
+template <int nPlaces, Type S, Overflow P>
+const std::overflow_error Decimal<nPlaces, S, P>::errOverflow("decimal overflow");
+template <int nPlaces, Type S, Overflow P>
+const std::invalid_argument Decimal<nPlaces, S, P>::errInvalidInput("invalid input");
+
+// from_chars parses a Decimal from [first, last) without throwing or allocating. It
+// follows std::from_chars: ptr points past the last character consumed, and ec is
+// invalid_argument if no number was found or result_out_of_range if it does not fit,
+// in which case value is left unmodified.
+template <int nPlaces, Type S, Overflow P>
+constexpr std::from_chars_result from_chars(const char* first, const char* last, Decimal<nPlaces, S, P>& value) {
+    return Decimal<nPlaces, S, P>::parse(first, last, value.fp);
+}
 
-    // multiplies the current Decimal object by f0.
-    Decimal& operator*=(const Decimal& f0) {
-        fp = mul(fp, f0.fp);
-        return *this;
-    }
+// Operators on Decimals with different places give a result with the larger number of
+// places. Products truncate and quotients round half away from zero, as for operands
+// with the same places; mul and div choose the places and rounding.
+template <int A, int B, Type S, Overflow P, typename = std::enable_if_t<A != B>>
+constexpr Decimal<(A > B ? A : B), S, P> operator*(const Decimal<A, S, P>& a, const Decimal<B, S, P>& b) {
+    return a.template mul<(A > B ? A : B)>(b);
+}
 
-    Decimal operator/(const Decimal& f0) const { return {div(fp, f0.fp)}; }
+template <int A, int B, Type S, Overflow P, typename = std::enable_if_t<A != B>>
+constexpr Decimal<(A > B ? A : B), S, P> operator/(const Decimal<A, S, P>& a, const Decimal<B, S, P>& b) {
+    return a.template div<(A > B ? A : B)>(b);
+}
 
-    // divides the current Decimal object by f0.
-    Decimal& operator/=(const Decimal& f0) {
-        fp = div(fp, f0.fp);
-        return *this;
+template <int A, int B, Type S, Overflow P, typename = std::enable_if_t<A != B>>
+constexpr Decimal<(A > B ? A : B), S, P> operator+(const Decimal<A, S, P>& a, const Decimal<B, S, P>& b) {
+    return a.template convert_precision<(A > B ? A : B)>() + b.template convert_precision<(A > B ? A : B)>();
+}
+
+template <int A, int B, Type S, Overflow P, typename = std::enable_if_t<A != B>>
+constexpr Decimal<(A > B ? A : B), S, P> operator-(const Decimal<A, S, P>& a, const Decimal<B, S, P>& b) {
+    return a.template convert_precision<(A > B ? A : B)>() - b.template convert_precision<(A > B ? A : B)>();
+}
+
+// fma returns a * b + c with a single rounding according to R, after the addition.
+template <Rounding R = Rounding::Truncate, int N, Type T, Overflow Q>
+constexpr Decimal<N, T, Q> fma(const Decimal<N, T, Q>& a, const Decimal<N, T, Q>& b, const Decimal<N, T, Q>& c) {
+    using D = Decimal<N, T, Q>;
+    detail::ProductSum<T> sum;
+    sum.add(a.fp, b.fp);
+    sum.add(c.fp, D::scale);
+    return {D::template rescaled_sum<R, N>(sum)};
+}
+
+// dot returns the sum of a[i] * b[i] for i < n with the larger of the two places. The
+// products are summed exactly in a 256-bit integer and rounded once at the end according
+// to R, so there is one division for the whole range rather than one per element.
+template <Rounding R = Rounding::Truncate, int A, int B, Type T, Overflow Q>
+constexpr Decimal<(A > B ? A : B), T, Q> dot(const Decimal<A, T, Q>* a, const Decimal<B, T, Q>* b, std::size_t n) {
+    detail::ProductSum<T> sum;
+    for (std::size_t i = 0; i < n; ++i) {
+        sum.add(a[i].fp, b[i].fp);
     }
+    return {Decimal<(A > B ? A : B), T, Q>::template rescaled_sum<R, (A < B ? A : B)>(sum)};
+}
 
-    bool operator==(const Decimal& rhs) const { return fp == rhs.fp; }
-    bool operator!=(const Decimal& rhs) const { return fp != rhs.fp; }
-    bool operator<(const Decimal& rhs) const { return fp < rhs.fp; }
-    bool operator<=(const Decimal& rhs) const { return fp <= rhs.fp; }
-    bool operator>(const Decimal& rhs) const { return fp > rhs.fp; }
-    bool operator>=(const Decimal& rhs) const { return fp >= rhs.fp; }
+// dot over two contiguous ranges, such as std::vector, std::array or std::span, uses the
+// shorter of the two lengths.
+template <Rounding R = Rounding::Truncate, typename RangeA, typename RangeB,
+          typename = std::void_t<decltype(std::data(std::declval<const RangeA&>())), decltype(std::data(std::declval<const RangeB&>()))>>
+constexpr auto dot(const RangeA& a, const RangeB& b) {
+    return dot<R>(std::data(a), std::data(b), std::min<std::size_t>(std::size(a), std::size(b)));
+}
 
-    [[nodiscard]] std::string to_string() const {
-        std::string s = to_str();
+// reduce_sum returns the sum of the n Decimals at first, summed exactly in an Accumulator
+// and checked once, so intermediate sums may leave the Decimal's range.
+template <int nPlaces, Type S, Overflow P>
+Decimal<nPlaces, S, P> reduce_sum(const Decimal<nPlaces, S, P>* first, std::size_t n) {
+    return typename Decimal<nPlaces, S, P>::Accumulator().add(first, n).value();
+}
 
-        std::size_t point = s.find('.');
-        if (point == std::string::npos) {
-            return s;
-        }
+// reduce_minmax returns the smallest and largest of the n Decimals at first. An empty
+// range gives the largest and smallest Decimals, the identities for merging results.
+template <int nPlaces, Type S, Overflow P>
+std::pair<Decimal<nPlaces, S, P>, Decimal<nPlaces, S, P>> reduce_minmax(const Decimal<nPlaces, S, P>* first, std::size_t n) {
+    using D = Decimal<nPlaces, S, P>;
+    auto lo = D::max_fp, hi = D::min_fp;
+    detail::minmax_fp(&first->fp, n, lo, hi);
+    return {D(lo), D(hi)};
+}
 
-        std::size_t index = s.length() - 1;
-        while (index != point) {
-            if (s[index] != '0') {
-                return s.substr(0, index + 1);
-            }
-            index--;
-        }
+// mean returns the mean of the n Decimals at first, rounded according to R. It throws
+// for an empty range.
+template <Rounding R = Rounding::HalfUp, int nPlaces, Type S, Overflow P>
+Decimal<nPlaces, S, P> mean(const Decimal<nPlaces, S, P>* first, std::size_t n) {
+    return typename Decimal<nPlaces, S, P>::Accumulator().add(first, n).template mean<R>(n);
+}
 
-        return s.substr(0, point);
-    }
+#ifdef __cpp_lib_span
+template <int nPlaces, Type S, Overflow P>
+Decimal<nPlaces, S, P> reduce_sum(std::span<const Decimal<nPlaces, S, P>> values) {
+    return reduce_sum(values.data(), values.size());
+}
 
-    [[nodiscard]] std::string to_string(int decimals) const {
-        std::string s = to_str();
+template <int nPlaces, Type S, Overflow P>
+std::pair<Decimal<nPlaces, S, P>, Decimal<nPlaces, S, P>> reduce_minmax(std::span<const Decimal<nPlaces, S, P>> values) {
+    return reduce_minmax(values.data(), values.size());
+}
 
-        std::size_t point = s.find('.');
-        if (point == std::string::npos) {
-            return s;
-        }
+template <Rounding R = Rounding::HalfUp, int nPlaces, Type S, Overflow P>
+Decimal<nPlaces, S, P> mean(std::span<const Decimal<nPlaces, S, P>> values) {
+    return mean<R>(values.data(), values.size());
+}
+#endif
 
-        if (decimals == 0) {
-            return s.substr(0, point);
-        } else {
-            return s.substr(0, point + decimals + 1);
-        }
+#ifdef __cpp_lib_execution
+namespace detail {
+// Parallel reductions split a range into blocks of kParallelBlock values, whatever the
+// policy, and merge the exact per-block results, so the result never depends on how the
+// work was scheduled.
+constexpr std::size_t kParallelBlock = 1 << 16;
+
+template <typename Policy, typename T, typename Reduce, typename Transform>
+T reduce_blocks(Policy&& policy, std::size_t n, T init, Reduce reduce, Transform transform) {
+    std::vector<std::size_t> starts((n + kParallelBlock - 1) / kParallelBlock);
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+        starts[i] = i * kParallelBlock;
     }
+    return std::transform_reduce(std::forward<Policy>(policy), starts.begin(), starts.end(), init, reduce,
+                                 [&](std::size_t start) { return transform(start, std::min(kParallelBlock, n - start)); });
+}
 
-    [[nodiscard]] IntType to_int() const { return fp / scale; }
+template <typename Policy>
+using if_execution_policy = std::enable_if_t<std::is_execution_policy_v<std::decay_t<Policy>>>;
+}  // namespace detail
 
-    [[nodiscard]] double to_frac() const { return static_cast<double>(fp % scale) / scale; }
+// The execution policy overloads split the range across threads as the policy allows, such
+// as std::execution::par_unseq. They give the same results as the sequential versions.
+// With libstdc++ the parallel policies run on TBB when its headers are found, and the
+// program must then link TBB (-ltbb, or TBB::tbb in CMake).
+template <typename Policy, int nPlaces, Type S, Overflow P, typename = detail::if_execution_policy<Policy>>
+Decimal<nPlaces, S, P> reduce_sum(Policy&& policy, const Decimal<nPlaces, S, P>* first, std::size_t n) {
+    using Accumulator = typename Decimal<nPlaces, S, P>::Accumulator;
+    return detail::reduce_blocks(
+               std::forward<Policy>(policy), n, Accumulator(), [](Accumulator a, const Accumulator& b) { return a += b; },
+               [first](std::size_t start, std::size_t m) { return Accumulator().add(first + start, m); })
+        .value();
+}
 
-    [[nodiscard]] Decimal round(int n) const {
-        if (n >= nPlaces) {
-            return *this;
-        }
+template <typename Policy, int nPlaces, Type S, Overflow P, typename = detail::if_execution_policy<Policy>>
+std::pair<Decimal<nPlaces, S, P>, Decimal<nPlaces, S, P>> reduce_minmax(Policy&& policy, const Decimal<nPlaces, S, P>* first,
+                                                                        std::size_t n) {
+    using D = Decimal<nPlaces, S, P>;
+    using MinMax = std::pair<D, D>;
+    return detail::reduce_blocks(
+        std::forward<Policy>(policy), n, MinMax(D(D::max_fp), D(D::min_fp)),
+        [](const MinMax& a, const MinMax& b) { return MinMax(std::min(a.first, b.first), std::max(a.second, b.second)); },
+        [first](std::size_t start, std::size_t m) { return reduce_minmax(first + start, m); });
+}
 
-        if (n == 0) {
-            return fp - (fp % scale);
-        }
+template <Rounding R = Rounding::HalfUp, typename Policy, int nPlaces, Type S, Overflow P,
+          typename = detail::if_execution_policy<Policy>>
+Decimal<nPlaces, S, P> mean(Policy&& policy, const Decimal<nPlaces, S, P>* first, std::size_t n) {
+    using Accumulator = typename Decimal<nPlaces, S, P>::Accumulator;
+    return detail::reduce_blocks(
+               std::forward<Policy>(policy), n, Accumulator(), [](Accumulator a, const Accumulator& b) { return a += b; },
+               [first](std::size_t start, std::size_t m) { return Accumulator().add(first + start, m); })
+        .template mean<R>(n);
+}
+#endif
 
-        IntType frac = fp % scale;
-        IntType f0 = fp - frac;
+// The batch namespace holds element-wise kernels over contiguous Decimal arrays. They
+// never throw: each returns the index of the first element whose result is out of range,
+// or n if there is none, and out holds valid results for every index before that.
+namespace batch {
+
+namespace detail {
 
-        auto pow = detail::precomputed_pow_10<IntType>(nPlaces - n);
+#if defined(__AVX512F__)
+// Eight lanes at a time. Lanes that overflow, wrap or leave [min_fp, max_fp] are flagged.
+template <int nPlaces, Type S, Overflow P, bool subtract>
+std::size_t add_sub_simd(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>* b, Decimal<nPlaces, S, P>* out,
+                         std::size_t n) {
+    using D = Decimal<nPlaces, S, P>;
+    static_assert(sizeof(D) == sizeof(int64_t));
+    const __m512i max = _mm512_set1_epi64(static_cast<int64_t>(D::max_fp));
+    const __m512i min = _mm512_set1_epi64(static_cast<int64_t>(D::min_fp));
+    const __m512i zero = _mm512_setzero_si512();
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i va = _mm512_loadu_si512(&a[i].fp);
+        __m512i vb = _mm512_loadu_si512(&b[i].fp);
+        __m512i r = subtract ? _mm512_sub_epi64(va, vb) : _mm512_add_epi64(va, vb);
+
+        __mmask8 bad;
         if constexpr (S == Signed) {
-            if (fp < 0) {
-                frac -= pow / 2;  // rounding factor
-            } else {
-                frac += pow / 2;  // rounding factor
-            }
+            __m512i wrap = subtract ? _mm512_and_si512(_mm512_xor_si512(va, vb), _mm512_xor_si512(va, r))
+                                    : _mm512_and_si512(_mm512_xor_si512(va, r), _mm512_xor_si512(vb, r));
+            bad = _mm512_cmplt_epi64_mask(wrap, zero) | _mm512_cmpgt_epi64_mask(r, max) | _mm512_cmplt_epi64_mask(r, min);
         } else {
-            frac += pow / 2;  // rounding factor
+            __mmask8 wrap = subtract ? _mm512_cmplt_epu64_mask(va, vb) : _mm512_cmplt_epu64_mask(r, va);
+            bad = wrap | _mm512_cmpgt_epu64_mask(r, max);
         }
-        frac /= pow;
-        frac *= pow;
 
-        IntType new_fp = f0 + frac;
-
-        return {new_fp};
+        if (unlikely(bad != 0)) {
+            break;
+        }
+        _mm512_storeu_si512(&out[i].fp, r);
     }
-
-    // convert_precision allows converting a Decimal from one precision to another.
-    // A conversion  moving the number of places right, will just be a lossy conversion
-    // A conversion moving the number of places left will throw an overflow error
-    // if it is not possible
-    template <int toPlaces>
-    Decimal<toPlaces, S> convert_precision() const {
-        if constexpr (toPlaces == nPlaces) {
-            return Decimal<toPlaces, S>(*this);
-        } else if constexpr (toPlaces < nPlaces) {
-            if constexpr (detail::has_int128) {
-                return Decimal<toPlaces, S>(div(fp, scale), nPlaces);
-            } else {
-                static constexpr IntType factor = scale / detail::const_pow<10, toPlaces>();
-                return Decimal<toPlaces, S>(fp / factor);
-            }
+    return i;
+}
+#elif defined(__AVX2__)
+// Four lanes at a time. Lanes that overflow, wrap or leave [min_fp, max_fp] are flagged.
+template <int nPlaces, Type S, Overflow P, bool subtract>
+std::size_t add_sub_simd(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>* b, Decimal<nPlaces, S, P>* out,
+                         std::size_t n) {
+    using D = Decimal<nPlaces, S, P>;
+    static_assert(sizeof(D) == sizeof(int64_t));
+    // AVX2 only compares signed lanes, so unsigned values are biased by the sign bit.
+    const __m256i bias = _mm256_set1_epi64x(S == Signed ? 0 : std::numeric_limits<int64_t>::min());
+    const __m256i max = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(D::max_fp)), bias);
+    const __m256i min = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(D::min_fp)), bias);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&a[i].fp));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b[i].fp));
+        __m256i r = subtract ? _mm256_sub_epi64(va, vb) : _mm256_add_epi64(va, vb);
+
+        __m256i wrap;
+        if constexpr (S == Signed) {
+            wrap = subtract ? _mm256_and_si256(_mm256_xor_si256(va, vb), _mm256_xor_si256(va, r))
+                            : _mm256_and_si256(_mm256_xor_si256(va, r), _mm256_xor_si256(vb, r));
         } else {
-            static constexpr IntType factor = detail::const_pow<10, toPlaces>() / scale;
-            if (unlikely(fp > std::numeric_limits<IntType>::max() / factor)) {
-                throw errOverflow;
-            }
-            if constexpr (S == Signed) {
-                if (unlikely(fp < std::numeric_limits<IntType>::min() / factor)) {
-                    throw errOverflow;
-                }
-            }
-            return Decimal<toPlaces, S>(fp * factor);
+            wrap = subtract ? _mm256_cmpgt_epi64(_mm256_xor_si256(vb, bias), _mm256_xor_si256(va, bias))
+                            : _mm256_cmpgt_epi64(_mm256_xor_si256(va, bias), _mm256_xor_si256(r, bias));
         }
-    }
+        __m256i biased = _mm256_xor_si256(r, bias);
+        __m256i bad = _mm256_or_si256(wrap, _mm256_or_si256(_mm256_cmpgt_epi64(biased, max), _mm256_cmpgt_epi64(min, biased)));
 
-    // decode_binary reads from a byte vector and sets the Decimal value
-    // It also updates the offset.
-    void decode_binary(const std::vector<uint8_t>& data, size_t& offset) {
-        IntType value = 0;
-        int shift = 0;
-        for (; offset < data.size() - 1; ++offset) {
-            uint8_t byte = data[offset];
-            value |= static_cast<IntType>(byte & 0x7F) << shift;
-            if ((byte & 0x80) == 0) {
-                break;
-            }
-            shift += 7;
+        if (unlikely(_mm256_movemask_pd(_mm256_castsi256_pd(bad)) != 0)) {
+            break;
         }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&out[i].fp), r);
+    }
+    return i;
+}
+#else
+template <int nPlaces, Type S, Overflow P, bool subtract>
+std::size_t add_sub_simd(const Decimal<nPlaces, S, P>*, const Decimal<nPlaces, S, P>*, Decimal<nPlaces, S, P>*, std::size_t) {
+    return 0;
+}
+#endif
 
-        int extracted_nPlaces = data[offset + 1];
-        if (extracted_nPlaces != nPlaces) {
-            if (extracted_nPlaces > nPlaces) {
-                value /= detail::precomputed_pow_10<IntType>(extracted_nPlaces - nPlaces);
-            } else {
-                value *= detail::precomputed_pow_10<IntType>(nPlaces - extracted_nPlaces);
-            }
-        }
+}  // namespace detail
 
-        fp = value;
-        offset += 2;  // We also read one extra byte for the 'nPlaces' information
+// add stores a[i] + b[i] in out[i].
+template <int nPlaces, Type S, Overflow P>
+std::size_t add(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>* b, Decimal<nPlaces, S, P>* out, std::size_t n) {
+    // The vector loop stops at the first block with a bad lane, which is then redone here.
+    std::size_t i = 0;
+    if constexpr (sizeof(Decimal<nPlaces, S, P>) == sizeof(int64_t)) {
+        i = detail::add_sub_simd<nPlaces, S, P, false>(a, b, out, n);
     }
-
-    // decode_binary_data reads from a byte vector, sets the Decimal value, and returns the new offset
-    size_t decode_binary_data(const std::vector<uint8_t>& data, size_t offset = 0) {
-        decode_binary(data, offset);
-        return offset;  // offset has been updated in decode_binary
+    for (; i < n; ++i) {
+        if (unlikely(a[i].checked_add(b[i], out[i]) != std::errc())) {
+            return i;
+        }
     }
+    return n;
+}
 
-    // encode_binary serializes the Decimal value into a byte vector and updates the offset.
-    void encode_binary(std::vector<uint8_t>& data, size_t& offset) const {
-        IntType value = fp;
-        do {
-            uint8_t byte = value & 0x7F;
-            value >>= 7;
-            if (value != 0) {
-                byte |= 0x80;
-            }
-
-            // Ensure that the vector can accommodate the new byte
-            if (offset >= data.size()) {
-                data.resize(offset + 1);
-            }
-            data[offset] = byte;
-            ++offset;
-        } while (value != 0);
+// sub stores a[i] - b[i] in out[i].
+template <int nPlaces, Type S, Overflow P>
+std::size_t sub(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>* b, Decimal<nPlaces, S, P>* out, std::size_t n) {
+    std::size_t i = 0;
+    if constexpr (sizeof(Decimal<nPlaces, S, P>) == sizeof(int64_t)) {
+        i = detail::add_sub_simd<nPlaces, S, P, true>(a, b, out, n);
+    }
+    for (; i < n; ++i) {
+        if (unlikely(a[i].checked_sub(b[i], out[i]) != std::errc())) {
+            return i;
+        }
+    }
+    return n;
+}
 
-        // Add nPlaces as an additional byte at the end
-        if (offset >= data.size()) {
-            data.resize(offset + 1);
+// mul_scalar stores a[i] * b in out[i], truncated like operator*.
+template <int nPlaces, Type S, Overflow P>
+std::size_t mul_scalar(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>& b, Decimal<nPlaces, S, P>* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (unlikely(a[i].checked_mul(b, out[i]) != std::errc())) {
+            return i;
         }
-        data[offset] = static_cast<uint8_t>(nPlaces);
-        ++offset;
     }
+    return n;
+}
 
-    // Overloaded version of encode_binary that creates a new vector
-    [[nodiscard]] std::vector<uint8_t> encode_binary() const {
-        std::vector<uint8_t> data;
-        size_t offset = 0;
-        encode_binary(data, offset);
-        return data;
+// mul stores a[i] * b[i] in out[i], truncated like operator*.
+template <int nPlaces, Type S, Overflow P>
+std::size_t mul(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>* b, Decimal<nPlaces, S, P>* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (unlikely(a[i].checked_mul(b[i], out[i]) != std::errc())) {
+            return i;
+        }
     }
+    return n;
+}
 
-   private:
-    IntType parseInteger(const std::string& s) {
-        if constexpr (S == Signed) {
-            return std::stoll(s);
-        } else {
-            return std::stoull(s);
+// fma stores a[i] * b[i] + c[i] in out[i], truncating once after the addition.
+template <int nPlaces, Type S, Overflow P>
+std::size_t fma(const Decimal<nPlaces, S, P>* a, const Decimal<nPlaces, S, P>* b, const Decimal<nPlaces, S, P>* c,
+                Decimal<nPlaces, S, P>* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (unlikely(a[i].checked_fma(b[i], c[i], out[i]) != std::errc())) {
+            return i;
         }
     }
+    return n;
+}
 
-    static IntType mul(IntType fp, IntType f0) {
-        IntType fp_a = fp / scale;
-        IntType fp_b = fp % scale;
+#ifdef __cpp_lib_span
+template <int nPlaces, Type S, Overflow P>
+std::size_t add(std::span<const Decimal<nPlaces, S, P>> a, std::span<const Decimal<nPlaces, S, P>> b,
+                std::span<Decimal<nPlaces, S, P>> out) {
+    return add(a.data(), b.data(), out.data(), std::min({a.size(), b.size(), out.size()}));
+}
 
-        IntType fp0_a = f0 / scale;
-        IntType fp0_b = f0 % scale;
+template <int nPlaces, Type S, Overflow P>
+std::size_t sub(std::span<const Decimal<nPlaces, S, P>> a, std::span<const Decimal<nPlaces, S, P>> b,
+                std::span<Decimal<nPlaces, S, P>> out) {
+    return sub(a.data(), b.data(), out.data(), std::min({a.size(), b.size(), out.size()}));
+}
 
-        IntType result = 0;
+template <int nPlaces, Type S, Overflow P>
+std::size_t mul_scalar(std::span<const Decimal<nPlaces, S, P>> a, const Decimal<nPlaces, S, P>& b,
+                       std::span<Decimal<nPlaces, S, P>> out) {
+    return mul_scalar(a.data(), b, out.data(), std::min(a.size(), out.size()));
+}
 
-        if (fp0_a != 0) {
-            result = fp_a * fp0_a;
-            if (unlikely(static_cast<double>(result) > MAX)) {
-                throw errOverflow;
-            }
-            result = (result * scale) + (fp_b * fp0_a);
-        }
+template <int nPlaces, Type S, Overflow P>
+std::size_t mul(std::span<const Decimal<nPlaces, S, P>> a, std::span<const Decimal<nPlaces, S, P>> b,
+                std::span<Decimal<nPlaces, S, P>> out) {
+    return mul(a.data(), b.data(), out.data(), std::min({a.size(), b.size(), out.size()}));
+}
 
-        if (fp0_b != 0) {
-            result = result + (fp_a * fp0_b) + (fp_b * fp0_b) / scale;
-        }
+template <int nPlaces, Type S, Overflow P>
+std::size_t fma(std::span<const Decimal<nPlaces, S, P>> a, std::span<const Decimal<nPlaces, S, P>> b,
+                std::span<const Decimal<nPlaces, S, P>> c, std::span<Decimal<nPlaces, S, P>> out) {
+    return fma(a.data(), b.data(), c.data(), out.data(), std::min({a.size(), b.size(), c.size(), out.size()}));
+}
+#endif
+
+}  // namespace batch
+
+template <typename D>
+class Atomic;
+
+// Atomic holds a 64-bit Decimal in a std::atomic of its integer, so every operation is
+// lock-free. fetch_add and fetch_sub apply P like the operators, retrying with
+// compare-and-swap until no other thread got in between; under Throw a result that does
+// not fit throws and leaves the value untouched. Wrap and Unchecked use the integer's
+// own fetch_add and fetch_sub.
+template <int nPlaces, Type S, Overflow P>
+class Atomic<Decimal<nPlaces, S, P>> {
+   public:
+    using value_type = Decimal<nPlaces, S, P>;
+    using IntType = typename value_type::IntType;
+
+    static_assert(sizeof(IntType) == sizeof(int64_t), "Atomic needs a 64-bit Decimal to be lock-free");
+    static constexpr bool is_always_lock_free = std::atomic<IntType>::is_always_lock_free;
 
-        return result;
+    Atomic() noexcept = default;
+    constexpr Atomic(value_type d) noexcept : fp(d.fp) {}
+    Atomic(const Atomic&) = delete;
+    Atomic& operator=(const Atomic&) = delete;
+
+    [[nodiscard]] bool is_lock_free() const noexcept { return fp.is_lock_free(); }
+
+    [[nodiscard]] value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return {fp.load(order)};
     }
 
-    using DivT = typename std::conditional<detail::has_int128, IntType, double>::type;
+    void store(value_type d, std::memory_order order = std::memory_order_seq_cst) noexcept { fp.store(d.fp, order); }
 
-    static __int128 abs128(__int128 x) { return x < 0 ? -x : x; }
+    operator value_type() const noexcept { return load(); }
 
-    static DivT div(IntType fp, IntType f0) {
-        if (unlikely(f0 == 0)) {
-            throw errDivByZero;
-        }
+    value_type operator=(value_type d) noexcept {
+        store(d);
+        return d;
+    }
 
-        if constexpr (detail::has_int128) {
-            __int128 temp = static_cast<__int128>(fp) * scale;
-            __int128 remainder = temp % f0;
-            temp /= f0;
+    value_type exchange(value_type d, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return {fp.exchange(d.fp, order)};
+    }
 
-            if (unlikely(temp > std::numeric_limits<IntType>::max())) {
-                throw errOverflow;
-            }
+    bool compare_exchange_weak(value_type& expected, value_type desired, std::memory_order success,
+                               std::memory_order failure) noexcept {
+        return fp.compare_exchange_weak(expected.fp, desired.fp, success, failure);
+    }
 
-            auto quotient = static_cast<IntType>(temp);
+    bool compare_exchange_weak(value_type& expected, value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return fp.compare_exchange_weak(expected.fp, desired.fp, order);
+    }
 
-            if constexpr (S == Signed) {
-                if (abs128(remainder) * 2 >= abs128(f0)) {
-                    // Adjust quotient based on the sign of fp and f0
-                    quotient += (fp ^ f0) < 0 ? -1 : 1;
-                }
-            } else {
-                if (remainder * 2 >= f0) {
-                    ++quotient;  // rounding factor
-                }
-            }
-            return quotient;
+    bool compare_exchange_strong(value_type& expected, value_type desired, std::memory_order success,
+                                 std::memory_order failure) noexcept {
+        return fp.compare_exchange_strong(expected.fp, desired.fp, success, failure);
+    }
+
+    bool compare_exchange_strong(value_type& expected, value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return fp.compare_exchange_strong(expected.fp, desired.fp, order);
+    }
+
+    // fetch_add adds d and returns the previous value.
+    value_type fetch_add(value_type d, std::memory_order order = std::memory_order_seq_cst) {
+        if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+            return {fp.fetch_add(d.fp, order)};
         } else {
-            return double(fp) / double(f0);
+            return update([d](value_type old) { return old + d; }, order);
         }
     }
 
-    static IntType newI(IntType i, uint32_t n) {
-        if (n > nPlaces) {
-            auto pow = detail::precomputed_pow_10<IntType>(n - nPlaces);
-            if constexpr (S == Signed) {
-                if (i < 0) {
-                    i -= pow / 2;  // rounding factor
-                } else {
-                    i += pow / 2;  // rounding factor
-                }
-            } else {
-                i += pow / 2;  // rounding factor
-            }
-            i /= pow;
-            n = nPlaces;
+    // fetch_sub subtracts d and returns the previous value.
+    value_type fetch_sub(value_type d, std::memory_order order = std::memory_order_seq_cst) {
+        if constexpr (P == Overflow::Wrap || P == Overflow::Unchecked) {
+            return {fp.fetch_sub(d.fp, order)};
+        } else {
+            return update([d](value_type old) { return old - d; }, order);
         }
-        i *= detail::precomputed_pow_10<IntType>(nPlaces - n);
-        return i;
     }
 
-    [[nodiscard]] std::string to_str() const {
-        if (fp == 0) {
-            static const std::string zero_str = "0." + zeros();
-            return zero_str;
+    // fetch_max raises the value to d if d is larger and returns the previous value.
+    value_type fetch_max(value_type d, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        IntType old = fp.load(failure_order(order));
+        while (old < d.fp && !fp.compare_exchange_weak(old, d.fp, order, failure_order(order))) {
         }
+        return {old};
+    }
 
-        IntType val = fp;
-        if constexpr (S == Signed) {
-            if (fp < 0) {
-                val = -fp;
-            }
+    // fetch_min lowers the value to d if d is smaller and returns the previous value.
+    value_type fetch_min(value_type d, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        IntType old = fp.load(failure_order(order));
+        while (d.fp < old && !fp.compare_exchange_weak(old, d.fp, order, failure_order(order))) {
         }
+        return {old};
+    }
 
-        std::array<char, 25> buf;
-        int i = sizeof(buf) - 1;
-        int idec = i - nPlaces;
-
-        while (val >= 10 || i >= idec) {
-            buf[i] = static_cast<char>(val % 10 + '0');
-            i--;
-            if (i == idec) {
-                buf[i] = '.';
-                i--;
-            }
-            val /= 10;
+   private:
+    // failure_order is the strongest order a failed compare-and-swap, which only loads,
+    // may use for an operation with the given order.
+    static constexpr std::memory_order failure_order(std::memory_order order) {
+        switch (order) {
+            case std::memory_order_acq_rel:
+                return std::memory_order_acquire;
+            case std::memory_order_release:
+                return std::memory_order_relaxed;
+            default:
+                return order;
         }
+    }
 
-        buf[i] = static_cast<char>(val + '0');
-
-        if constexpr (S == Signed) {
-            if (fp < 0) {
-                i--;
-                buf[i] = '-';
-            }
+    // update stores f(old) in place of old, retrying if another thread changed the value
+    // first, and returns old. If f throws, the value is left untouched.
+    template <typename F>
+    value_type update(F f, std::memory_order order) {
+        IntType old = fp.load(std::memory_order_relaxed);
+        while (!fp.compare_exchange_weak(old, f(value_type(old)).fp, order, std::memory_order_relaxed)) {
         }
-
-        return {std::next(buf.begin(), i), buf.end()};
+        return {old};
     }
 
-    static int max(int a, int b) { return (a > b) ? a : b; }
+    std::atomic<IntType> fp{0};
 };
 
-template <int nPlaces, Type S>
-const std::runtime_error Decimal<nPlaces, S>::errDivByZero("division by zero");
-template <int nPlaces, Type S>
-const std::overflow_error Decimal<nPlaces, S>::errTooLarge("number is too large");
-template <int nPlaces, Type S>
-const std::overflow_error Decimal<nPlaces, S>::errOverflow("decimal overflow");
-template <int nPlaces, Type S>
-const std::invalid_argument Decimal<nPlaces, S>::errInvalidInput("invalid input");
-
-template <int nPlaces, Type S>
-std::ostream& operator<<(std::ostream& os, const Decimal<nPlaces, S>& d) {
+template <int nPlaces, Type S, Overflow P>
+std::ostream& operator<<(std::ostream& os, const Decimal<nPlaces, S, P>& d) {
     os << d.to_string();
     return os;
 }
@@ -703,6 +3269,61 @@ using I15 = Decimal<15, Signed>;
 using I16 = Decimal<16, Signed>;
 using I17 = Decimal<17, Signed>;
 
+namespace detail {
+// literal holds the value of the numeric literal c..., parsed while compiling.
+template <typename D, char... c>
+struct literal {
+    static constexpr char chars[] = {c..., '\0'};
+    static constexpr D value = D(chars);
+};
+}  // namespace detail
+
+// User-defined literals for the aliases above, such as 1.25_u8 or -0.5_i4. The value is
+// always computed at compile time, and a literal that does not fit fails to compile.
+inline namespace literals {
+#define DECIMAL_LITERAL(D, suffix) \
+    template <char... c>           \
+    constexpr D operator""_##suffix() { return detail::literal<D, c...>::value; }
+
+DECIMAL_LITERAL(U1, u1)
+DECIMAL_LITERAL(U2, u2)
+DECIMAL_LITERAL(U3, u3)
+DECIMAL_LITERAL(U4, u4)
+DECIMAL_LITERAL(U5, u5)
+DECIMAL_LITERAL(U6, u6)
+DECIMAL_LITERAL(U7, u7)
+DECIMAL_LITERAL(U8, u8)
+DECIMAL_LITERAL(U9, u9)
+DECIMAL_LITERAL(U10, u10)
+DECIMAL_LITERAL(U11, u11)
+DECIMAL_LITERAL(U12, u12)
+DECIMAL_LITERAL(U13, u13)
+DECIMAL_LITERAL(U14, u14)
+DECIMAL_LITERAL(U15, u15)
+DECIMAL_LITERAL(U16, u16)
+DECIMAL_LITERAL(U17, u17)
+DECIMAL_LITERAL(U18, u18)
+DECIMAL_LITERAL(I1, i1)
+DECIMAL_LITERAL(I2, i2)
+DECIMAL_LITERAL(I3, i3)
+DECIMAL_LITERAL(I4, i4)
+DECIMAL_LITERAL(I5, i5)
+DECIMAL_LITERAL(I6, i6)
+DECIMAL_LITERAL(I7, i7)
+DECIMAL_LITERAL(I8, i8)
+DECIMAL_LITERAL(I9, i9)
+DECIMAL_LITERAL(I10, i10)
+DECIMAL_LITERAL(I11, i11)
+DECIMAL_LITERAL(I12, i12)
+DECIMAL_LITERAL(I13, i13)
+DECIMAL_LITERAL(I14, i14)
+DECIMAL_LITERAL(I15, i15)
+DECIMAL_LITERAL(I16, i16)
+DECIMAL_LITERAL(I17, i17)
+
+#undef DECIMAL_LITERAL
+}  // namespace literals
+
 }  // namespace decimal
 
 #endif  // CPP_DECIMAL_H
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <cwchar>
 #include <iostream>
+#include <thread>
 
 using decimal::Decimal;
 
@@ -215,6 +216,148 @@ TEST_F(DecimalTest, Parse) {
     ASSERT_THROW(decimal::I8("abc"), std::invalid_argument);
 }
 
+TEST_F(DecimalTest, ParseCharRange) {
+    std::string_view sv = "123.456";
+    ASSERT_EQ(decimal::U8(sv).to_string(), "123.456");
+    ASSERT_EQ(decimal::I8(std::string_view("-123.456")).to_string(), "-123.456");
+
+    const char buf[] = "99.5|100.25";
+    ASSERT_EQ(decimal::U2(buf, buf + 4).to_string(), "99.5");
+    ASSERT_EQ(decimal::U2(buf + 5, buf + 11).to_string(), "100.25");
+
+    ASSERT_EQ(decimal::U8("+1.5").to_string(), "1.5");
+    ASSERT_EQ(decimal::U8("1.").to_string(), "1");
+    ASSERT_EQ(decimal::U8("-0").to_string(), "0");
+    ASSERT_EQ(decimal::I8("-0.5").to_string(), "-0.5");
+    ASSERT_EQ(decimal::U2("1.999").to_string(), "1.99");
+
+    ASSERT_THROW(decimal::U8(""), std::invalid_argument);
+    ASSERT_THROW(decimal::U8("."), std::invalid_argument);
+    ASSERT_THROW(decimal::I8("-"), std::invalid_argument);
+    ASSERT_THROW(decimal::U8("1.5x"), std::invalid_argument);
+    ASSERT_THROW(decimal::U8("1..5"), std::invalid_argument);
+    ASSERT_THROW(decimal::U8(" 1"), std::invalid_argument);
+    ASSERT_THROW(decimal::I1("100000000000000000"), std::overflow_error);
+    ASSERT_THROW(decimal::U8("00000000000000000000000000123456789012"), std::overflow_error);
+    ASSERT_EQ(decimal::U8("000000000000000000000000001").to_string(), "1");
+}
+
+TEST_F(DecimalTest, FromChars) {
+    const std::string buf = "123.456,-7.5,abc,123456789012,1.";
+    const char* first = buf.data();
+    const char* last = buf.data() + buf.size();
+
+    decimal::I8 d;
+    auto res = decimal::from_chars(first, last, d);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.ptr, first + 7);
+    ASSERT_EQ(d.to_string(), "123.456");
+
+    res = decimal::from_chars(res.ptr + 1, last, d);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(*res.ptr, ',');
+    ASSERT_EQ(d.to_string(), "-7.5");
+
+    const char* abc = res.ptr + 1;
+    res = decimal::from_chars(abc, last, d);
+    ASSERT_EQ(res.ec, std::errc::invalid_argument);
+    ASSERT_EQ(res.ptr, abc);
+    ASSERT_EQ(d.to_string(), "-7.5");
+
+    res = decimal::from_chars(abc + 4, last, d);
+    ASSERT_EQ(res.ec, std::errc::result_out_of_range);
+    ASSERT_EQ(res.ptr, abc + 16);
+    ASSERT_EQ(d.to_string(), "-7.5");
+
+    res = decimal::from_chars(res.ptr + 1, last, d);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.ptr, last);
+    ASSERT_EQ(d.to_string(), "1");
+
+    decimal::U8 u;
+    std::string neg = "-1.5";
+    res = decimal::from_chars(neg.data(), neg.data() + neg.size(), u);
+    ASSERT_EQ(res.ec, std::errc::result_out_of_range);
+    ASSERT_EQ(res.ptr, neg.data() + neg.size());
+    ASSERT_TRUE(u.is_zero());
+}
+
+TEST_F(DecimalTest, ScientificNotation) {
+    ASSERT_EQ(decimal::U8("1.23e-5").fp, 1230);
+    ASSERT_EQ(decimal::U8("1.23E-5").to_string(), "0.0000123");
+    ASSERT_EQ(decimal::U8("1e8").to_string(), "100000000");
+    ASSERT_EQ(decimal::U8("1.5e+2").to_string(), "150");
+    ASSERT_EQ(decimal::U8(".5e1").to_string(), "5");
+    ASSERT_EQ(decimal::U8("0.000123e3").to_string(), "0.123");
+    ASSERT_EQ(decimal::U2("1.23456789e3").to_string(), "1234.57");
+    ASSERT_EQ(decimal::U2("123456e-5").to_string(), "1.23");
+    ASSERT_EQ(decimal::U8("5e-9").fp, 1);
+    ASSERT_EQ(decimal::U8("4e-9").fp, 0);
+    ASSERT_EQ(decimal::U8("1e-400").fp, 0);
+    ASSERT_EQ(decimal::U8("123456789012e-5").to_string(), "1234567.89012");
+    ASSERT_EQ(decimal::U8("12345678901234567890123e-12").to_string(), "12345678901.23456789");
+
+    ASSERT_EQ(decimal::I8("-1.23e-5").fp, -1230);
+    ASSERT_EQ(decimal::I8("-5e-9").fp, -1);
+    ASSERT_EQ(decimal::I8("-1e8").to_string(), "-100000000");
+    ASSERT_EQ(decimal::I2("-1.005e0").to_string(), "-1.01");
+
+    ASSERT_THROW(decimal::U8("1e11"), std::overflow_error);
+    ASSERT_THROW(decimal::I8("-1e10"), std::overflow_error);
+    ASSERT_THROW(decimal::U8("1e400"), std::overflow_error);
+    ASSERT_THROW(decimal::U8("-1e-2"), std::overflow_error);
+    ASSERT_THROW(decimal::U8("1e"), std::invalid_argument);
+    ASSERT_THROW(decimal::U8("1e+"), std::invalid_argument);
+    ASSERT_THROW(decimal::U8("e5"), std::invalid_argument);
+    ASSERT_EQ(decimal::U8("99999999999.999999994e0").to_string(), "99999999999.99999999");
+    ASSERT_THROW(decimal::U8("99999999999.999999995e0"), std::overflow_error);
+
+    decimal::U8 d;
+    const std::string buf = "2.5e3x";
+    auto res = decimal::from_chars(buf.data(), buf.data() + buf.size(), d);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(*res.ptr, 'x');
+    ASSERT_EQ(d.to_string(), "2500");
+}
+
+TEST_F(DecimalTest, ParseBatch) {
+    std::vector<std::string> strings = {"123.456", "-7.5",           "0",      "1.",    ".25",   "9999999999.99999999", "-9999999999",
+                                        "1e3",     "1.123456789123", "+2.5",   "0001",  "-0.0",  "1234567890123456",    "12.3456789"};
+    std::vector<std::string_view> fields(strings.begin(), strings.end());
+    std::vector<decimal::I8> out(fields.size());
+
+    ASSERT_EQ(decimal::I8::parse_batch(fields.data(), fields.data() + fields.size(), out.data()), 12u);
+    for (std::size_t i = 0; i < 12; ++i) {
+        ASSERT_EQ(out[i], decimal::I8(strings[i])) << strings[i];
+    }
+
+    std::vector<decimal::U2> prices(fields.size());
+    ASSERT_EQ(decimal::U2::parse_batch(fields.data(), fields.data() + fields.size(), prices.data()), 1u);
+    ASSERT_EQ(prices[0].to_string(), "123.45");
+
+    std::vector<std::string_view> bad = {"1.5", "1.2.3", "12a4", ""};
+    std::vector<decimal::U8> u(bad.size());
+    ASSERT_EQ(decimal::U8::parse_batch(bad.data(), bad.data() + bad.size(), u.data()), 1u);
+    ASSERT_EQ(decimal::U8::parse_batch(bad.data() + 3, bad.data() + 4, u.data()), 0u);
+
+    std::vector<std::string> random;
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < 1000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        decimal::I8 d(static_cast<int64_t>((x >> (i % 40)) % 1000000000000000000) * (i % 2 == 0 ? 1 : -1));
+        random.push_back(d.to_string());
+    }
+    std::vector<std::string_view> random_fields(random.begin(), random.end());
+    std::vector<decimal::I8> random_out(random.size());
+    ASSERT_EQ(decimal::I8::parse_batch(random_fields.data(), random_fields.data() + random_fields.size(), random_out.data()),
+              random.size());
+    for (std::size_t i = 0; i < random.size(); ++i) {
+        ASSERT_EQ(random_out[i].to_string(), random[i]);
+    }
+}
+
 TEST_F(DecimalTest, NewIU8) {
     decimal::U8 f = decimal::U8(123, 1);
     ASSERT_EQ(f.to_string(), "12.3");
@@ -469,6 +612,11 @@ TEST_F(DecimalTest, AddSubU8) {
         f0 += decimal::U8("0.1");
     }
     ASSERT_EQ(f0.to_string(), "1");
+
+    f0 = decimal::U8("60000000000") + decimal::U8("39999999999.99999999");
+    ASSERT_EQ(f0.to_string(), "99999999999.99999999");
+    ASSERT_THROW(f0 + decimal::U8("0.00000001"), std::overflow_error);
+    ASSERT_THROW(f0 += decimal::U8("0.00000001"), std::overflow_error);
 }
 
 TEST_F(DecimalTest, AddSubI8) {
@@ -507,6 +655,17 @@ TEST_F(DecimalTest, AddSubI8) {
         f0 = f0 + decimal::I8("0.1");  // Note: Adding to a negative
     }
     ASSERT_EQ(f0.to_string(), "1");
+
+    f0 = decimal::I8("6000000000") + decimal::I8("3999999999.99999999");
+    ASSERT_EQ(f0.to_string(), "9999999999.99999999");
+    ASSERT_THROW(f0 + decimal::I8("0.00000001"), std::overflow_error);
+    ASSERT_THROW(decimal::I8("-9999999999.99999999") - decimal::I8("0.00000001"), std::overflow_error);
+
+    f0 = decimal::I8("-1");
+    f0 -= decimal::I8("1");
+    ASSERT_EQ(f0.to_string(), "-2");
+    f0 += decimal::I8("-1");
+    ASSERT_EQ(f0.to_string(), "-3");
 }
 
 TEST_F(DecimalTest, MulDivU8) {
@@ -771,6 +930,584 @@ TEST_F(DecimalTest, MulDivI8) {
     ASSERT_EQ(f2.to_string(), "0.1");
 }
 
+TEST_F(DecimalTest, MulRounding) {
+    // Products that need the full 128 bits are exact rather than truncating the cross term.
+    decimal::I12 a("123456.789012345678");
+    decimal::I12 b("-0.000001234567");
+    ASSERT_EQ((a * b).to_string(), "-0.15241567764");
+    ASSERT_EQ(a.mul<decimal::Rounding::HalfUp>(b).to_string(), "-0.152415677641");
+    ASSERT_EQ(a.mul<decimal::Rounding::Floor>(b).to_string(), "-0.152415677641");
+    ASSERT_EQ(a.mul<decimal::Rounding::Ceil>(b).to_string(), "-0.15241567764");
+
+    decimal::U8 big("99999.99999999");
+    ASSERT_EQ((big * big).to_string(), "9999999999.998");
+    ASSERT_EQ(big.mul<decimal::Rounding::Ceil>(big).to_string(), "9999999999.99800001");
+
+    decimal::U2 half("0.5");
+    ASSERT_EQ((decimal::U2("0.05") * half).to_string(), "0.02");
+    ASSERT_EQ(decimal::U2("0.05").mul<decimal::Rounding::HalfUp>(half).to_string(), "0.03");
+    ASSERT_EQ(decimal::U2("0.05").mul<decimal::Rounding::HalfEven>(half).to_string(), "0.02");
+    ASSERT_EQ(decimal::U2("0.07").mul<decimal::Rounding::HalfEven>(half).to_string(), "0.04");
+    ASSERT_EQ(decimal::U2("0.07").mul<decimal::Rounding::Floor>(half).to_string(), "0.03");
+    ASSERT_EQ(decimal::U2("0.07").mul<decimal::Rounding::Ceil>(half).to_string(), "0.04");
+
+    decimal::I2 neg("-0.05");
+    ASSERT_EQ(neg.mul<decimal::Rounding::HalfUp>(decimal::I2("0.5")).to_string(), "-0.03");
+    ASSERT_EQ(neg.mul<decimal::Rounding::HalfEven>(decimal::I2("0.5")).to_string(), "-0.02");
+    ASSERT_EQ(neg.mul<decimal::Rounding::Floor>(decimal::I2("0.5")).to_string(), "-0.03");
+    ASSERT_EQ(neg.mul<decimal::Rounding::Ceil>(decimal::I2("0.5")).to_string(), "-0.02");
+
+    // Overflow is detected exactly at the edge of the range.
+    decimal::I8 lo("-99999.99999999");
+    decimal::I8 hi("100000.00000001");
+    ASSERT_EQ((lo * hi).to_string(), "-9999999999.99999999");
+    ASSERT_THROW((void)lo.mul<decimal::Rounding::HalfUp>(hi), std::overflow_error);
+    ASSERT_THROW((void)lo.mul<decimal::Rounding::Floor>(hi), std::overflow_error);
+    ASSERT_THROW(decimal::I8("9999999999.99999999") * decimal::I8("1.00000001"), std::overflow_error);
+    ASSERT_THROW(decimal::U8("9999999999.99999999") * decimal::U8("9999999999.99999999"), std::overflow_error);
+    ASSERT_EQ(decimal::U8("9999999999.99999999").mul<decimal::Rounding::Floor>(decimal::U8("0.99999999")).to_string(),
+              "9999999899.99999999");
+}
+
+TEST_F(DecimalTest, CheckedArithmetic) {
+    decimal::I8 out("42");
+    ASSERT_EQ(decimal::I8("1.5").checked_add(decimal::I8("2.25"), out), std::errc());
+    ASSERT_EQ(out.to_string(), "3.75");
+    ASSERT_EQ(decimal::I8("1.5").checked_sub(decimal::I8("2.25"), out), std::errc());
+    ASSERT_EQ(out.to_string(), "-0.75");
+    ASSERT_EQ(decimal::I8("1.5").checked_mul(decimal::I8("2.25"), out), std::errc());
+    ASSERT_EQ(out.to_string(), "3.375");
+    ASSERT_EQ(decimal::I8("2").checked_div(decimal::I8("-3"), out), std::errc());
+    ASSERT_EQ(out.to_string(), "-0.66666667");
+    ASSERT_EQ(decimal::I8("0.00000001").checked_mul<decimal::Rounding::HalfUp>(decimal::I8("0.5"), out), std::errc());
+    ASSERT_EQ(out.fp, 1);
+
+    // Failures leave out untouched.
+    out = decimal::I8("42");
+    decimal::I8 max(decimal::I8::max_fp);
+    decimal::I8 min(decimal::I8::min_fp);
+    ASSERT_EQ(max.checked_add(decimal::I8("0.00000001"), out), std::errc::result_out_of_range);
+    ASSERT_EQ(min.checked_sub(decimal::I8("0.00000001"), out), std::errc::result_out_of_range);
+    ASSERT_EQ(max.checked_mul(decimal::I8("1.00000001"), out), std::errc::result_out_of_range);
+    ASSERT_EQ(max.checked_div(decimal::I8("0.5"), out), std::errc::result_out_of_range);
+    ASSERT_EQ(max.checked_div(decimal::I8(), out), std::errc::argument_out_of_domain);
+    ASSERT_EQ(out.to_string(), "42");
+
+    ASSERT_EQ(max.checked_add(min, out), std::errc());
+    ASSERT_TRUE(out.is_zero());
+    ASSERT_EQ(max.checked_sub(decimal::I8("0.00000001"), out), std::errc());
+    ASSERT_EQ(out.fp, decimal::I8::max_fp - 1);
+
+    // The raw values themselves overflowing is caught too, not only the range check.
+    decimal::U8 umax(decimal::U8::max_fp);
+    decimal::U8 uout;
+    ASSERT_EQ(umax.checked_add(umax, uout), std::errc::result_out_of_range);
+    ASSERT_EQ(decimal::U8("1").checked_sub(decimal::U8("2"), uout), std::errc::result_out_of_range);
+    ASSERT_EQ(decimal::U8("2").checked_sub(decimal::U8("1"), uout), std::errc());
+    ASSERT_EQ(uout.to_string(), "1");
+
+    // The operators report the same failures as exceptions.
+    ASSERT_THROW(max + decimal::I8("0.00000001"), std::overflow_error);
+    ASSERT_THROW(min - decimal::I8("0.00000001"), std::overflow_error);
+    ASSERT_THROW(max / decimal::I8(), std::runtime_error);
+    ASSERT_THROW(umax + umax, std::overflow_error);
+}
+
+TEST_F(DecimalTest, PowerOfTenDivision) {
+    uint64_t x = 88172645463325252ULL;
+    auto next = [&x]() {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return x;
+    };
+    // Rounds half away from zero, as div, round and convert_precision do.
+    auto ref_div = [](__int128 n, __int128 d) {
+        __int128 q = n / d;
+        __int128 r = n % d;
+        if ((r < 0 ? -r : r) * 2 >= (d < 0 ? -d : d)) {
+            q += (n < 0) != (d < 0) ? -1 : 1;
+        }
+        return q;
+    };
+
+    for (int i = 0; i < 10000; ++i) {
+        decimal::I8 a(static_cast<int64_t>(next() >> (1 + i % 60)) * (i % 2 == 0 ? 1 : -1));
+        decimal::I8 b(static_cast<int64_t>((next() >> (20 + i % 40)) | 1) * (i % 3 == 0 ? 1 : -1));
+        __int128 q = ref_div(static_cast<__int128>(a.fp) * decimal::I8::scale, b.fp);
+        if (q > decimal::I8::max_fp || q < decimal::I8::min_fp) {
+            ASSERT_THROW(a / b, std::overflow_error);
+        } else {
+            ASSERT_EQ((a / b).fp, q);
+        }
+
+        a.fp %= decimal::I8::max_fp;
+        for (int n = 1; n < 8; ++n) {
+            auto pow = static_cast<int64_t>(decimal::detail::precomputed_pow_10<int64_t>(8 - n));
+            ASSERT_EQ(a.round(n).fp, a.fp / decimal::I8::scale * decimal::I8::scale + ref_div(a.fp % decimal::I8::scale, pow) * pow);
+        }
+        ASSERT_EQ(a.convert_precision<3>().fp, ref_div(a.fp, 100000));
+        ASSERT_EQ(decimal::I8(a.fp, 11).fp, ref_div(a.fp, 1000));
+    }
+
+    ASSERT_EQ(decimal::I8("-1.125").convert_precision<2>().to_string(), "-1.13");
+    ASSERT_EQ(decimal::I8("-1.124").convert_precision<2>().to_string(), "-1.12");
+    ASSERT_EQ(decimal::U18("1.844674407370955165").round(17).to_string(), "1.84467440737095517");
+    ASSERT_THROW(decimal::I8("9999999999") / decimal::I8("0.5"), std::overflow_error);
+    ASSERT_THROW(decimal::I8("-9999999999") / decimal::I8("0.5"), std::overflow_error);
+    ASSERT_EQ((decimal::I8("-9999999999") / decimal::I8("-1.5")).to_string(), "6666666666");
+}
+
+TEST_F(DecimalTest, OverflowPolicies) {
+    using SatU8 = decimal::Decimal<8, decimal::Unsigned, decimal::Overflow::Saturate>;
+    using SatI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Saturate>;
+    using WrapU8 = decimal::Decimal<8, decimal::Unsigned, decimal::Overflow::Wrap>;
+    using WrapI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Wrap>;
+    using UncI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Unchecked>;
+
+    SatU8 smax(SatU8::max_fp);
+    ASSERT_EQ((smax + SatU8("1")).fp, SatU8::max_fp);
+    ASSERT_EQ((SatU8("1") - SatU8("2")).fp, 0u);
+    ASSERT_EQ((smax * SatU8("2")).fp, SatU8::max_fp);
+    ASSERT_EQ((smax / SatU8("0.5")).fp, SatU8::max_fp);
+    ASSERT_EQ(SatU8("1.5") + SatU8("2.25"), SatU8("3.75"));
+    ASSERT_THROW(SatU8("1") / SatU8("0"), std::runtime_error);
+
+    SatI8 imax(SatI8::max_fp);
+    SatI8 imin(SatI8::min_fp);
+    ASSERT_EQ((imax + SatI8("1")).fp, SatI8::max_fp);
+    ASSERT_EQ((imin - SatI8("1")).fp, SatI8::min_fp);
+    ASSERT_EQ((imax * SatI8("-2")).fp, SatI8::min_fp);
+    ASSERT_EQ((imin * SatI8("-2")).fp, SatI8::max_fp);
+    ASSERT_EQ((imin / SatI8("0.5")).fp, SatI8::min_fp);
+    ASSERT_EQ(SatI8("-1.5") * SatI8("2"), SatI8("-3"));
+
+    decimal::Decimal<1, decimal::Signed, decimal::Overflow::Saturate> big("-12345678901234567");
+    ASSERT_EQ(big.convert_precision<17>().fp, (decimal::Decimal<17, decimal::Signed, decimal::Overflow::Saturate>::min_fp));
+
+    // Converting to more places stays within [min_fp, max_fp], not just the IntType range.
+    constexpr int64_t factor = 1000000;
+    SatI8 top = decimal::Decimal<2, decimal::Signed, decimal::Overflow::Saturate>(SatI8::max_fp / factor).convert_precision<8>();
+    ASSERT_EQ(top.fp, SatI8::max_fp / factor * factor);
+    top = decimal::Decimal<2, decimal::Signed, decimal::Overflow::Saturate>(SatI8::max_fp / factor + 1).convert_precision<8>();
+    ASSERT_EQ(top.fp, SatI8::max_fp);
+    SatI8 bottom = decimal::Decimal<2, decimal::Signed, decimal::Overflow::Saturate>(SatI8::min_fp / factor - 1).convert_precision<8>();
+    ASSERT_EQ(bottom.fp, SatI8::min_fp);
+    ASSERT_NO_THROW(decimal::I2(decimal::I8::max_fp / factor).convert_precision<8>());
+    ASSERT_THROW(decimal::I2(decimal::I8::max_fp / factor + 1).convert_precision<8>(), std::overflow_error);
+    ASSERT_THROW(decimal::I2(decimal::I8::min_fp / factor - 1).convert_precision<8>(), std::overflow_error);
+
+    WrapU8 wmax(std::numeric_limits<uint64_t>::max());
+    ASSERT_EQ((wmax + WrapU8(uint64_t(2))).fp, 1u);
+    ASSERT_EQ((WrapU8(uint64_t(0)) - WrapU8(uint64_t(1))).fp, std::numeric_limits<uint64_t>::max());
+    ASSERT_EQ(WrapU8("1.5") * WrapU8("2.5"), WrapU8("3.75"));
+    ASSERT_EQ(WrapU8("1") / WrapU8("8"), WrapU8("0.125"));
+
+    WrapI8 wimax(std::numeric_limits<int64_t>::max());
+    ASSERT_EQ((wimax + WrapI8(int64_t(1))).fp, std::numeric_limits<int64_t>::min());
+    ASSERT_EQ(WrapI8("-1.5") * WrapI8("2.5"), WrapI8("-3.75"));
+    ASSERT_THROW(WrapI8("1") / WrapI8("0"), std::runtime_error);
+
+    ASSERT_EQ(UncI8("-1.25") + UncI8("3.5"), UncI8("2.25"));
+    ASSERT_EQ(UncI8("-1.25") * UncI8("3.5"), UncI8("-4.375"));
+    ASSERT_EQ(UncI8("-1") / UncI8("4"), UncI8("-0.25"));
+    ASSERT_EQ(UncI8("0.5").convert_precision<2>(), (decimal::Decimal<2, decimal::Signed, decimal::Overflow::Unchecked>("0.5")));
+
+    SatI8 converted(decimal::I8("-2.5"));
+    ASSERT_EQ(converted.to_string(), "-2.5");
+}
+
+TEST_F(DecimalTest, ConstexprAndLiterals) {
+    using namespace decimal::literals;
+
+    constexpr decimal::U8 tick = 0.25_u8;
+    static_assert(tick.fp == 25000000);
+    static_assert(decimal::U8("0.25") == tick);
+    static_assert(decimal::U8(25, 2) == tick);
+    static_assert(decimal::I8("-1.5e2") == -150_i8);
+    static_assert(1_u8 + tick == 1.25_u8);
+    static_assert(1_u8 - tick == 0.75_u8);
+    static_assert(1.5_u8 * tick == 0.375_u8);
+    static_assert(1_i8 / 3_i8 == 0.33333333_i8);
+    static_assert(-2_i8 / 3_i8 == -0.66666667_i8);
+    static_assert(1.25_u8 .round(1) == 1.3_u8);
+    static_assert(1.2345_u4 .convert_precision<2>() == 1.23_u2);
+    static_assert(1.25_u4 .mul<decimal::Rounding::HalfEven>(0.5_u4) == 0.625_u4);
+    static_assert(-1.5_i8 < 0_i8 && -(-1.5_i8) == 1.5_i8);
+
+    constexpr std::array<decimal::U4, 3> fees = {0.001_u4, 0.0025_u4, 0.01_u4};
+    static_assert(fees[0] < fees[1] && fees[1] < fees[2]);
+
+    ASSERT_EQ((100_u2).to_string(), "100");
+    ASSERT_EQ((-0.5_i4).to_string(), "-0.5");
+    ASSERT_EQ((1e-3_u8).to_string(), "0.001");
+    ASSERT_EQ(tick * decimal::U8("4"), 1_u8);
+}
+
+TEST_F(DecimalTest, WideDecimals) {
+    using W18 = decimal::Decimal<18, decimal::WideSigned>;
+    using WU18 = decimal::Decimal<18, decimal::WideUnsigned>;
+    using W30 = decimal::Decimal<30, decimal::WideSigned>;
+
+    ASSERT_EQ(W18::digits, 38);
+    ASSERT_EQ(W18("-99999999999999999999.999999999999999999").to_string(), "-99999999999999999999.999999999999999999");
+    ASSERT_EQ(WU18("12345678901234567890.123456789012345678").to_string(), "12345678901234567890.123456789012345678");
+    ASSERT_EQ(W30("12345678.000000000000000000000000000001").to_string(), "12345678.000000000000000000000000000001");
+    ASSERT_EQ(W18("1.5e19").to_string(), "15000000000000000000");
+    ASSERT_EQ(W18("123.456").to_string(2), "123.45");
+    ASSERT_THROW(W18("100000000000000000000"), std::overflow_error);
+
+    W18 qty("123456789012.123456789012345678");
+    W18 price("98765.432109876543210987");
+    ASSERT_EQ((qty * price).to_string(), "12193263113680231.659680425238708451");
+    ASSERT_EQ((qty / price).to_string(), "1249999.988607125001256394");
+    ASSERT_EQ((-qty + price).to_string(), "-123456690246.691346912469134691");
+    ASSERT_EQ((W30("-1") / W30("3")).to_string(), "-0.333333333333333333333333333333");
+    ASSERT_EQ(W18("2.5").mul<decimal::Rounding::HalfEven>(W18("0.000000000000000001")), W18("0.000000000000000002"));
+    ASSERT_THROW(W18("99999999999999999999") * W18("2"), std::overflow_error);
+    ASSERT_THROW(W18("1") / W18("0"), std::runtime_error);
+
+    using SatW18 = decimal::Decimal<18, decimal::WideSigned, decimal::Overflow::Saturate>;
+    ASSERT_EQ((SatW18(SatW18::min_fp) - SatW18("1")).fp, SatW18::min_fp);
+    ASSERT_EQ((SatW18("-99999999999999999999") * SatW18("3")).fp, SatW18::min_fp);
+
+    ASSERT_EQ(W18("1.555").round(2), W18("1.56"));
+    ASSERT_EQ(W18("-1.25").convert_precision<1>().to_string(), "-1.3");
+    ASSERT_EQ(W18("12.5").convert_precision<30>().to_string(), "12.5");
+    ASSERT_EQ(W18::FromExp(5, 19).to_string(), "50000000000000000000");
+    ASSERT_DOUBLE_EQ(W18("-2.75").to_double(), -2.75);
+    ASSERT_EQ(W18(1.25).to_string(), "1.25");
+
+    static_assert(W18("0.000000000000000001") * W18("1000000000000000000") == W18("1"));
+
+    W18 parsed;
+    std::string_view text = "-42.000000000000000001x";
+    auto res = decimal::from_chars(text.data(), text.data() + text.size(), parsed);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(parsed.to_string(), "-42.000000000000000001");
+
+    std::array<W18, 3> a = {W18("1.5"), W18("-2"), W18("99999999999999999999")};
+    std::array<W18, 3> b = {W18("0.5"), W18("3"), W18("1")};
+    std::array<W18, 3> c = {W18("1"), W18("1"), W18("0")};
+    std::array<W18, 3> out;
+    ASSERT_EQ(decimal::batch::add(a.data(), b.data(), out.data(), 3), 2u);
+    ASSERT_EQ(out[1], W18("1"));
+    ASSERT_EQ(decimal::batch::fma(a.data(), b.data(), c.data(), out.data(), 3), 3u);
+    ASSERT_EQ(out[0], W18("1.75"));
+    ASSERT_EQ(out[1], W18("-5"));
+
+    WU18 big("12345678901234567890.123456789012345678");
+    WU18 decoded;
+    decoded.decode_binary_data(big.encode_binary());
+    ASSERT_EQ(decoded, big);
+}
+
+TEST_F(DecimalTest, MixedPrecision) {
+    using decimal::Rounding;
+    decimal::U2 price("123.45");
+    decimal::U8 qty("0.12345678");
+    ASSERT_EQ(price * qty, price.convert_precision<8>() * qty);
+    ASSERT_EQ((price * qty).to_string(), "15.24073949");
+    ASSERT_EQ((qty * price).to_string(), "15.24073949");
+    ASSERT_EQ(price.mul<2>(qty).to_string(), "15.24");
+    ASSERT_EQ((price.mul<2, Rounding::HalfUp>(qty).to_string()), "15.24");
+    ASSERT_EQ((price.mul<4, Rounding::Ceil>(qty).to_string()), "15.2408");
+    ASSERT_EQ((price / qty).to_string(), "999.945082");
+    ASSERT_EQ(price.div<2>(qty).to_string(), "999.95");
+    ASSERT_EQ((qty.div<4, Rounding::Truncate>(price).to_string()), "0.001");
+    ASSERT_EQ((price + qty).to_string(), "123.57345678");
+    ASSERT_EQ((price - qty).to_string(), "123.32654322");
+
+    decimal::I2 debit("-20.50");
+    decimal::I8 rate("1.00000001");
+    ASSERT_EQ((debit * rate).to_string(), "-20.5000002");
+    ASSERT_EQ((debit.mul<2, Rounding::Floor>(rate).to_string()), "-20.51");
+    ASSERT_EQ((rate / debit).to_string(), "-0.04878049");
+
+    ASSERT_THROW(decimal::U2("99999999999999999") * decimal::U8("100"), std::overflow_error);
+    ASSERT_THROW(price / decimal::U8("0"), std::runtime_error);
+
+    using W18 = decimal::Decimal<18, decimal::WideSigned>;
+    using W4 = decimal::Decimal<4, decimal::WideSigned>;
+    ASSERT_EQ((W4("-1234567890.1234") * W18("0.000000000000000003")).to_string(), "-0.00000000370370367");
+
+    // The dividend is scaled by 10^42 here, past what 128 bits hold.
+    using W30 = decimal::Decimal<30, decimal::WideSigned>;
+    ASSERT_EQ((W18("1") / W30("3")).to_string(), "0.333333333333333333333333333333");
+    ASSERT_EQ((W18("-2") / W30("3")).to_string(), "-0.666666666666666666666666666667");
+    ASSERT_EQ((W18("-2").div<30, Rounding::Truncate>(W30("3"))).to_string(), "-0.666666666666666666666666666666");
+    ASSERT_EQ((W18("12.5") / W30("-5000000")).to_string(), "-0.0000025");
+    ASSERT_THROW(W18("99999999") / W30("0.000000000000000000000000000001"), std::overflow_error);
+
+    static_assert(decimal::I2("1.50") * decimal::I8("2.00000001") == decimal::I8("3.000000015"));
+}
+
+TEST_F(DecimalTest, FmaAndDot) {
+    using decimal::Rounding;
+    decimal::U8 a("1.5"), b("2.00000001"), c("0.1");
+    ASSERT_EQ(decimal::fma(a, b, c).to_string(), "3.10000001");
+    ASSERT_EQ(decimal::fma(decimal::I8("-1.5"), decimal::I8("0.00000001"), decimal::I8("0")).to_string(), "-0.00000001");
+    ASSERT_EQ((decimal::fma<Rounding::Floor>(decimal::I8("-1.5"), decimal::I8("0.00000001"), decimal::I8("0")).to_string()), "-0.00000002");
+    // The product alone would be truncated before the addition.
+    ASSERT_EQ(decimal::fma(decimal::I8("0.00000005"), decimal::I8("0.5"), decimal::I8("-0.00000001")).to_string(), "0.00000001");
+    ASSERT_THROW(decimal::fma(decimal::U8("99999999999"), decimal::U8("1000"), decimal::U8("1")), std::overflow_error);
+
+    decimal::I8 out;
+    ASSERT_EQ(decimal::I8("-1.5").checked_fma<Rounding::Floor>(decimal::I8("0.00000001"), decimal::I8("0"), out), std::errc());
+    ASSERT_EQ(out, decimal::I8("-0.00000002"));
+    decimal::U8 unchanged("7");
+    ASSERT_EQ(decimal::U8("99999999999").checked_fma(decimal::U8("1000"), decimal::U8("1"), unchanged), std::errc::result_out_of_range);
+    ASSERT_EQ(unchanged, decimal::U8("7"));
+
+    std::vector<decimal::I2> prices = {decimal::I2("100.01"), decimal::I2("-99.99"), decimal::I2("0.03")};
+    std::vector<decimal::I8> qtys = {decimal::I8("0.12345678"), decimal::I8("0.12345678"), decimal::I8("0.00000001")};
+    ASSERT_EQ(decimal::dot(prices.data(), qtys.data(), prices.size()).to_string(), "0.00246913");
+    ASSERT_EQ((decimal::dot<Rounding::HalfUp>(prices.data(), qtys.data(), prices.size()).to_string()), "0.00246914");
+    ASSERT_EQ(decimal::dot(prices.data(), qtys.data(), 0), decimal::I8());
+    ASSERT_EQ(decimal::dot(prices, qtys).to_string(), "0.00246913");
+    std::array<decimal::I8, 2> first_two = {qtys[0], qtys[1]};
+    ASSERT_EQ(decimal::dot<Rounding::HalfUp>(prices, first_two).to_string(), "0.00246914");
+
+    // Intermediate sums may exceed the result's range as long as the total fits.
+    std::vector<decimal::I8> big = {decimal::I8("9000000000"), decimal::I8("9000000000"), decimal::I8("-9000000000")};
+    std::vector<decimal::I8> ones(3, decimal::I8("1"));
+    ASSERT_EQ(decimal::dot(big.data(), ones.data(), big.size()), decimal::I8("9000000000"));
+    std::vector<decimal::I8> twos(3, decimal::I8("2"));
+    ASSERT_THROW(decimal::dot(big.data(), twos.data(), big.size()), std::overflow_error);
+
+    using W1 = decimal::Decimal<1, decimal::WideSigned>;
+    std::vector<W1> w(20, W1("9999999999999999999999999999999999999"));
+    ASSERT_THROW(decimal::dot(w.data(), w.data(), w.size()), std::overflow_error);
+    std::vector<W1> tenths(10, W1("0.1"));
+    ASSERT_EQ(decimal::dot(w.data(), tenths.data(), tenths.size()).to_string(), "9999999999999999999999999999999999999");
+
+    static_assert(decimal::fma(decimal::I4("2"), decimal::I4("-3"), decimal::I4("1")) == decimal::I4("-5"));
+}
+
+TEST_F(DecimalTest, Accumulator) {
+    // Partial sums beyond the range of U8 are fine as long as the total is not.
+    decimal::U8 big("99999999999");
+    decimal::U8::Accumulator acc;
+    for (int i = 0; i < 1000; ++i) {
+        acc += big;
+    }
+    ASSERT_THROW((void)acc.value(), std::overflow_error);
+    decimal::U8 out("1");
+    ASSERT_EQ(acc.checked_value(out), std::errc::result_out_of_range);
+    ASSERT_EQ(out, decimal::U8("1"));
+
+    decimal::I8::Accumulator pnl;
+    for (int i = 0; i < 1000; ++i) {
+        pnl += decimal::I8("9000000000");
+        pnl += decimal::I8("-9000000000.00000001");
+    }
+    ASSERT_EQ(pnl.value(), decimal::I8("-0.00001"));
+
+    // Merging partial sums in any order gives the same total.
+    decimal::I8::Accumulator left, right;
+    left += decimal::I8("9000000000");
+    left += decimal::I8("9000000000");
+    right += decimal::I8("-9000000000");
+    right += decimal::I8("1.5");
+    decimal::I8::Accumulator total = left;
+    total += right;
+    ASSERT_EQ(total.value(), decimal::I8("9000000001.5"));
+    right += left;
+    ASSERT_EQ(right.value(), total.value());
+
+    using SatI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Saturate>;
+    SatI8::Accumulator sat;
+    sat += SatI8("-9000000000");
+    sat += SatI8("-9000000000");
+    ASSERT_EQ(sat.value().fp, SatI8::min_fp);
+
+    using W18 = decimal::Decimal<18, decimal::WideSigned>;
+    W18::Accumulator wide;
+    W18 w("-99999999999999999999");
+    for (int i = 0; i < 1000; ++i) {
+        wide += w;
+    }
+    ASSERT_THROW((void)wide.value(), std::overflow_error);
+    for (int i = 0; i < 1000; ++i) {
+        wide += -w;
+    }
+    wide += W18("0.000000000000000001");
+    ASSERT_EQ(wide.value(), W18("0.000000000000000001"));
+
+    static_assert([] {
+        decimal::I4::Accumulator a;
+        a += decimal::I4("1.5");
+        a += decimal::I4("-0.25");
+        return a.value();
+    }() == decimal::I4("1.25"));
+}
+
+TEST_F(DecimalTest, Reductions) {
+    std::vector<decimal::I8> values;
+    for (int i = 1; i <= 1000; ++i) {
+        values.push_back(decimal::I8(i % 2 == 0 ? i : -i, 2));
+    }
+    ASSERT_EQ(decimal::reduce_sum(values.data(), values.size()).to_string(), "5");
+    ASSERT_EQ(decimal::reduce_sum(values.data(), 3).to_string(), "-0.02");
+    ASSERT_EQ(decimal::mean(values.data(), values.size()).to_string(), "0.005");
+    ASSERT_EQ(decimal::mean(values.data(), 3).to_string(), "-0.00666667");
+    ASSERT_EQ((decimal::mean<decimal::Rounding::Truncate>(values.data(), 3).to_string()), "-0.00666666");
+    ASSERT_THROW((void)decimal::mean(values.data(), 0), std::runtime_error);
+
+    auto [lo, hi] = decimal::reduce_minmax(values.data(), values.size());
+    ASSERT_EQ(lo, decimal::I8("-9.99"));
+    ASSERT_EQ(hi, decimal::I8("10"));
+    auto empty = decimal::reduce_minmax(values.data(), 0);
+    ASSERT_EQ(empty.first.fp, decimal::I8::max_fp);
+    ASSERT_EQ(empty.second.fp, decimal::I8::min_fp);
+
+    // Only the total is range checked.
+    std::vector<decimal::U8> big(1000, decimal::U8("99999999999"));
+    ASSERT_THROW((void)decimal::reduce_sum(big.data(), big.size()), std::overflow_error);
+    ASSERT_EQ(decimal::mean(big.data(), big.size()), decimal::U8("99999999999"));
+    auto [ulo, uhi] = decimal::reduce_minmax(big.data(), big.size());
+    ASSERT_EQ(ulo, uhi);
+
+    using W8 = decimal::Decimal<8, decimal::WideSigned>;
+    std::vector<W8> wide = {W8("-1.5"), W8("4"), W8("0.5")};
+    ASSERT_EQ(decimal::reduce_sum(wide.data(), wide.size()), W8("3"));
+    ASSERT_EQ(decimal::mean(wide.data(), wide.size()), W8("1"));
+    ASSERT_EQ(decimal::reduce_minmax(wide.data(), wide.size()).first, W8("-1.5"));
+
+#ifdef __cpp_lib_execution
+    std::vector<decimal::I8> many(200000);
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        many[i].fp = static_cast<int64_t>(i * 7919 % 100003) * (i % 3 == 0 ? -1 : 1);
+    }
+    ASSERT_EQ(decimal::reduce_sum(std::execution::seq, many.data(), many.size()), decimal::reduce_sum(many.data(), many.size()));
+    ASSERT_EQ(decimal::reduce_minmax(std::execution::seq, many.data(), many.size()), decimal::reduce_minmax(many.data(), many.size()));
+    ASSERT_EQ(decimal::mean(std::execution::seq, many.data(), many.size()), decimal::mean(many.data(), many.size()));
+
+    // However the blocks are scheduled, the parallel results match the sequential ones.
+    for (int run = 0; run < 4; ++run) {
+        ASSERT_EQ(decimal::reduce_sum(std::execution::par_unseq, many.data(), many.size()), decimal::reduce_sum(many.data(), many.size()));
+        ASSERT_EQ(decimal::reduce_minmax(std::execution::par_unseq, many.data(), many.size()),
+                  decimal::reduce_minmax(many.data(), many.size()));
+        ASSERT_EQ(decimal::mean(std::execution::par, many.data(), many.size()), decimal::mean(many.data(), many.size()));
+    }
+#endif
+}
+
+TEST_F(DecimalTest, AtomicDecimal) {
+    static_assert(decimal::Atomic<decimal::U8>::is_always_lock_free);
+
+    decimal::Atomic<decimal::U8> last(decimal::U8("101.25"));
+    ASSERT_EQ(last.load(), decimal::U8("101.25"));
+    last.store(decimal::U8("101.5"));
+    ASSERT_EQ(last.exchange(decimal::U8("101.75")), decimal::U8("101.5"));
+    decimal::U8 expected("100");
+    ASSERT_FALSE(last.compare_exchange_strong(expected, decimal::U8("102")));
+    ASSERT_EQ(expected, decimal::U8("101.75"));
+    ASSERT_TRUE(last.compare_exchange_strong(expected, decimal::U8("102")));
+    ASSERT_EQ(decimal::U8(last), decimal::U8("102"));
+
+    ASSERT_EQ(last.fetch_max(decimal::U8("101")), decimal::U8("102"));
+    ASSERT_EQ(last.load(), decimal::U8("102"));
+    ASSERT_EQ(last.fetch_max(decimal::U8("103")), decimal::U8("102"));
+    ASSERT_EQ(last.fetch_min(decimal::U8("99.5")), decimal::U8("103"));
+    ASSERT_EQ(last.load(), decimal::U8("99.5"));
+
+    ASSERT_EQ(last.fetch_add(decimal::U8("0.5")), decimal::U8("99.5"));
+    ASSERT_EQ(last.fetch_sub(decimal::U8("100")), decimal::U8("100"));
+    ASSERT_THROW(last.fetch_sub(decimal::U8("1")), std::overflow_error);
+    ASSERT_EQ(last.load(), decimal::U8("0"));
+
+    using SatI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Saturate>;
+    decimal::Atomic<SatI8> sat(SatI8(SatI8::max_fp));
+    sat.fetch_add(SatI8("1"));
+    ASSERT_EQ(sat.load().fp, SatI8::max_fp);
+
+    using WrapI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Wrap>;
+    WrapI8 top, ulp;
+    top.fp = std::numeric_limits<int64_t>::max();
+    ulp.fp = 1;
+    decimal::Atomic<WrapI8> wrap(top);
+    wrap.fetch_add(ulp);
+    ASSERT_EQ(wrap.load().fp, std::numeric_limits<int64_t>::min());
+
+    decimal::Atomic<decimal::I8> volume, high(decimal::I8(decimal::I8::min_fp));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {
+                volume.fetch_add(decimal::I8("0.01"));
+                high.fetch_max(decimal::I8(t * 10000 + i, 0));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(volume.load(), decimal::I8("400"));
+    ASSERT_EQ(high.load(), decimal::I8("39999"));
+}
+
+TEST_F(DecimalTest, FromDoubleExact) {
+    ASSERT_EQ(decimal::U2(1.005), decimal::U2("1.01"));
+    ASSERT_EQ(decimal::I2(-1.005), decimal::I2("-1.01"));
+    ASSERT_EQ(decimal::I2(2.675), decimal::I2("2.68"));
+    ASSERT_EQ(decimal::U8(0.1 + 0.2), decimal::U8("0.3"));
+    ASSERT_EQ(decimal::I8(-0.000000005), decimal::I8("-0.00000001"));
+    ASSERT_EQ(decimal::I8(9876543210.1234), decimal::I8("9876543210.1234"));
+    ASSERT_EQ(decimal::U8(0.0), decimal::U8(0));
+    ASSERT_EQ(decimal::I8(-0.0), decimal::I8(0));
+
+    ASSERT_THROW(decimal::I8(std::nan("")), std::invalid_argument);
+    ASSERT_THROW(decimal::I8(std::numeric_limits<double>::infinity()), std::overflow_error);
+    ASSERT_THROW(decimal::I8(1e10), std::overflow_error);
+    ASSERT_THROW(decimal::U8(-0.5), std::overflow_error);
+
+    using W18 = decimal::Decimal<18, decimal::WideSigned>;
+    ASSERT_EQ(W18(0.1), W18("0.1"));
+    ASSERT_EQ(W18(-123456.000000000000000005), W18("-123456"));
+
+    std::vector<double> prices = {1.005, 101.25, 0.1 + 0.2, 3.14159, 42.0, 0.07, 19.99, 2.675, 7.5, 1e-9, 12.345};
+    std::vector<decimal::U2> out(prices.size());
+    ASSERT_EQ(decimal::U2::from_doubles(prices.data(), prices.data() + prices.size(), out.data()), prices.size());
+    for (std::size_t i = 0; i < prices.size(); ++i) {
+        ASSERT_EQ(out[i], decimal::U2(prices[i]));
+    }
+    ASSERT_EQ(out[0], decimal::U2("1.01"));
+    ASSERT_EQ(out[10], decimal::U2("12.35"));
+
+    prices[9] = std::nan("");
+    ASSERT_EQ(decimal::U2::from_doubles(prices.data(), prices.data() + prices.size(), out.data()), 9u);
+}
+
+TEST_F(DecimalTest, ToDoubleExact) {
+    ASSERT_EQ(decimal::U2("0.07").to_double(), 0.07);
+    ASSERT_EQ(decimal::I8("-1.005").to_double(), -1.005);
+    ASSERT_EQ(decimal::U8("12345.6789").to_double(), 12345.6789);
+
+    // 2^53 + 1 is not a double, so converting fp first would round twice.
+    decimal::I8 big;
+    big.fp = 9007199254740993;
+    ASSERT_EQ(big.to_double(), 90071992.54740994);
+    big.fp = -big.fp;
+    ASSERT_EQ(big.to_double(), -90071992.54740994);
+    ASSERT_EQ(decimal::I8(decimal::I8::max_fp).to_double(), 10000000000.0);
+
+    using W30 = decimal::Decimal<30, decimal::WideSigned>;
+    ASSERT_EQ(W30("123.456789012345678901234567890123").to_double(), 123.45678901234568);
+
+    std::vector<decimal::I8> values;
+    for (int i = 0; i < 37; ++i) {
+        decimal::I8 v;
+        v.fp = (i % 5 == 4 ? int64_t(1) << 53 : 1234567) * (i + 1) * (i % 2 == 0 ? 1 : -1) + i;
+        values.push_back(v);
+    }
+    std::vector<double> out(values.size());
+    decimal::I8::to_doubles(values.data(), values.data() + values.size(), out.data());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(out[i], values[i].to_double());
+    }
+}
+
 TEST_F(DecimalTest, NegativesU8) {
     ASSERT_THROW(decimal::U8("-1"), std::overflow_error);
     ASSERT_THROW(decimal::U8(-1.0), std::overflow_error);
@@ -961,6 +1698,96 @@ TEST_F(DecimalTest, StringI8) {
     ASSERT_EQ(s, "-1.12300000");
 }
 
+TEST_F(DecimalTest, ToChars) {
+    char buf[64];
+
+    auto f0 = decimal::U8("1234.5678");
+    auto res = f0.to_chars(buf, buf + sizeof(buf));
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(std::string(buf, res.ptr), "1234.5678");
+
+    res = f0.to_chars(buf, buf + sizeof(buf), 2);
+    ASSERT_EQ(std::string(buf, res.ptr), "1234.56");
+
+    res = f0.to_chars(buf, buf + sizeof(buf), 0);
+    ASSERT_EQ(std::string(buf, res.ptr), "1234");
+
+    res = f0.to_chars(buf, buf + sizeof(buf), 10);
+    ASSERT_EQ(std::string(buf, res.ptr), "1234.56780000");
+
+    res = decimal::U8("100").to_chars(buf, buf + sizeof(buf));
+    ASSERT_EQ(std::string(buf, res.ptr), "100");
+
+    res = decimal::U8().to_chars(buf, buf + sizeof(buf));
+    ASSERT_EQ(std::string(buf, res.ptr), "0");
+
+    res = decimal::I8("-0.001").to_chars(buf, buf + sizeof(buf));
+    ASSERT_EQ(std::string(buf, res.ptr), "-0.001");
+
+    res = decimal::I8("-0.001").to_chars(buf, buf + sizeof(buf), 2);
+    ASSERT_EQ(std::string(buf, res.ptr), "-0.00");
+
+    decimal::I2 min(std::numeric_limits<int64_t>::min());
+    res = min.to_chars(buf, buf + sizeof(buf));
+    ASSERT_EQ(std::string(buf, res.ptr), "-92233720368547758.08");
+
+    decimal::U1 max(std::numeric_limits<uint64_t>::max());
+    res = max.to_chars(buf, buf + decimal::U1::max_chars);
+    ASSERT_EQ(std::string(buf, res.ptr), "1844674407370955161.5");
+
+    res = f0.to_chars(buf, buf + 8);
+    ASSERT_EQ(res.ec, std::errc::value_too_large);
+    ASSERT_EQ(res.ptr, buf + 8);
+
+    res = f0.to_chars(buf, buf + 9);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(std::string(buf, res.ptr), "1234.5678");
+}
+
+template <typename D>
+void CheckFormatting(typename D::IntType fp) {
+    using U = typename D::IntType;
+    bool negative = fp < 0;
+    uint64_t mag = negative ? 0 - static_cast<uint64_t>(fp) : static_cast<uint64_t>(fp);
+    std::string frac = std::to_string(mag % static_cast<uint64_t>(D::scale));
+    frac = std::string(D::zeros().size() - frac.size(), '0') + frac;
+    std::string expected = (negative ? "-" : "") + std::to_string(mag / static_cast<uint64_t>(D::scale)) + "." + frac;
+    ASSERT_EQ(D(static_cast<U>(fp)).to_string(static_cast<int>(frac.size())), expected);
+}
+
+template <typename D>
+void CheckFormattingRange() {
+    using U = typename D::IntType;
+    for (U fp : {U(0), U(1), U(9), U(10), U(99), U(100), U(D::scale - 1), U(D::scale), U(D::scale + 1),
+                 std::numeric_limits<U>::max(), std::numeric_limits<U>::min()}) {
+        CheckFormatting<D>(fp);
+    }
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < 1000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        CheckFormatting<D>(static_cast<U>(x >> (i % 64)));
+    }
+}
+
+TEST_F(DecimalTest, FormatAllPlaces) {
+    CheckFormattingRange<decimal::U1>();
+    CheckFormattingRange<decimal::U2>();
+    CheckFormattingRange<decimal::U3>();
+    CheckFormattingRange<decimal::U8>();
+    CheckFormattingRange<decimal::U9>();
+    CheckFormattingRange<decimal::U17>();
+    CheckFormattingRange<decimal::U18>();
+
+    CheckFormattingRange<decimal::I1>();
+    CheckFormattingRange<decimal::I2>();
+    CheckFormattingRange<decimal::I7>();
+    CheckFormattingRange<decimal::I8>();
+    CheckFormattingRange<decimal::I16>();
+    CheckFormattingRange<decimal::I17>();
+}
+
 TEST_F(DecimalTest, RoundU8) {
     decimal::U8 f0 = decimal::U8("1.12345");
     decimal::U8 f1 = f0.round(2);
@@ -1281,9 +2108,10 @@ TEST_F(DecimalTest, ConvertPrecision_Signed) {
     decimal::I2 f15 = f14.convert_precision<2>();
     ASSERT_EQ(f15.to_string(), "1.12");
 
-    decimal::I1 f16("12345678901234567");
+    decimal::I1 f16("1234567890123456");
     decimal::I2 f17 = f16.convert_precision<2>();
     ASSERT_EQ(f16.to_string(), f17.to_string());
+    ASSERT_THROW(decimal::I1("12345678901234567").convert_precision<2>(), std::overflow_error);
 
     decimal::I17 f18("0.000000000000000001");
     decimal::I1 f19 = f18.convert_precision<1>();
@@ -1330,9 +2158,10 @@ TEST_F(DecimalTest, ConvertPrecision_Signed) {
     decimal::I2 nf15 = nf14.convert_precision<2>();
     ASSERT_EQ(nf15.to_string(), "-1.12");
 
-    decimal::I1 nf16("-12345678901234567");
+    decimal::I1 nf16("-1234567890123456");
     decimal::I2 nf17 = nf16.convert_precision<2>();
     ASSERT_EQ(nf16.to_string(), nf17.to_string());
+    ASSERT_THROW(decimal::I1("-12345678901234567").convert_precision<2>(), std::overflow_error);
 
     decimal::I17 nf18("-0.000000000000000001");
     decimal::I1 nf19 = nf18.convert_precision<1>();
@@ -1348,6 +2177,105 @@ TEST_F(DecimalTest, ConvertPrecision_Signed) {
     ASSERT_THROW(nf24.convert_precision<16>(), std::overflow_error);
 }
 
+template <typename D>
+void RunBatchArithmetic() {
+    using IntType = typename D::IntType;
+    constexpr std::size_t n = 103;
+    std::vector<D> a(n), b(n), c(n), out(n);
+    uint64_t x = 88172645463325252ULL;
+    auto next = [&x]() {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return x;
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = D(static_cast<IntType>(next() % static_cast<uint64_t>(D::max_fp / 2)));
+        b[i] = D(static_cast<IntType>(next() % static_cast<uint64_t>(D::max_fp / 2)));
+        c[i] = D(static_cast<IntType>(next() % static_cast<uint64_t>(D::scale * 100)));
+        if constexpr (std::is_signed_v<IntType>) {
+            if (i % 3 == 0) {
+                a[i].fp = -a[i].fp;
+            }
+            if (i % 5 == 0) {
+                b[i].fp = -b[i].fp;
+            }
+        }
+    }
+
+    ASSERT_EQ(decimal::batch::add(a.data(), b.data(), out.data(), n), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], a[i] + b[i]);
+    }
+
+    if constexpr (std::is_signed_v<IntType>) {
+        ASSERT_EQ(decimal::batch::sub(a.data(), b.data(), out.data(), n), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(out[i], a[i] - b[i]);
+        }
+    } else {
+        std::vector<D> hi(n), lo(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            hi[i] = std::max(a[i], b[i]);
+            lo[i] = std::min(a[i], b[i]);
+        }
+        ASSERT_EQ(decimal::batch::sub(hi.data(), lo.data(), out.data(), n), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(out[i], hi[i] - lo[i]);
+        }
+        ASSERT_LT(decimal::batch::sub(lo.data(), hi.data(), out.data(), n), n);
+    }
+
+    D k("1.5");
+    ASSERT_EQ(decimal::batch::mul_scalar(c.data(), k, out.data(), n), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], c[i] * k);
+    }
+
+    ASSERT_EQ(decimal::batch::mul(c.data(), c.data(), out.data(), n), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], c[i] * c[i]);
+    }
+
+    // Products by an integer are exact, so the single rounding of fma matches operator*.
+    std::vector<D> threes(n, D(3));
+    ASSERT_EQ(decimal::batch::fma(c.data(), threes.data(), a.data(), out.data(), n), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], c[i] * threes[i] + a[i]);
+    }
+
+    // Otherwise fma truncates once, after the addition.
+    std::vector<D> halves(n, D("0.5"));
+    std::vector<D> ones(n, D(static_cast<IntType>(1)));
+    ASSERT_EQ(decimal::batch::fma(ones.data(), halves.data(), ones.data(), out.data(), n), n);
+    ASSERT_EQ(out[0].fp, 1);
+    ASSERT_EQ(decimal::batch::mul(ones.data(), halves.data(), out.data(), n), n);
+    ASSERT_EQ(out[0].fp, 0);
+
+    // The first overflow is reported even when it falls inside a vector block.
+    a[61].fp = D::max_fp;
+    b[61].fp = 1;
+    a[90].fp = D::max_fp;
+    b[90].fp = D::max_fp;
+    ASSERT_EQ(decimal::batch::add(a.data(), b.data(), out.data(), n), 61u);
+    for (std::size_t i = 0; i < 61; ++i) {
+        ASSERT_EQ(out[i], a[i] + b[i]);
+    }
+    ASSERT_THROW(a[61] + b[61], std::overflow_error);
+
+    std::vector<D> big(n, D(D::max_fp));
+    ASSERT_EQ(decimal::batch::mul_scalar(big.data(), D(2), out.data(), n), 0u);
+    ASSERT_EQ(decimal::batch::add(big.data(), big.data(), out.data(), 0), 0u);
+}
+
+TEST_F(DecimalTest, BatchArithmetic) {
+    RunBatchArithmetic<decimal::U2>();
+    RunBatchArithmetic<decimal::U8>();
+    RunBatchArithmetic<decimal::I2>();
+    RunBatchArithmetic<decimal::I8>();
+    RunBatchArithmetic<decimal::I12>();
+}
+
 /* ---- */
 
 class DecimalEncodeDecodeTest : public ::testing::Test {
@@ -1419,6 +2347,262 @@ TEST_F(DecimalEncodeDecodeTest, DecodeBinaryData) {
     RunDecodeBinaryDataTest<11, decimal::Signed>();
 }
 
+TEST_F(DecimalEncodeDecodeTest, DecodeBytes) {
+    std::vector<uint8_t> buf;
+    size_t offset = 0;
+    decimal::U8("123.456").encode_binary(buf, offset);
+    decimal::U2("7.5").encode_binary(buf, offset);
+    buf.insert(buf.end(), extra_data.begin(), extra_data.end());
+
+    auto first = decimal::U8::decode_binary(buf.data(), buf.size());
+    ASSERT_EQ(first.ec, std::errc());
+    ASSERT_EQ(first.value, decimal::U8("123.456"));
+    auto second = decimal::U8::decode_binary(buf.data() + first.size, buf.size() - first.size);
+    ASSERT_EQ(second.ec, std::errc());
+    ASSERT_EQ(second.value, decimal::U8("7.5"));
+    ASSERT_EQ(first.size + second.size + extra_data.size(), buf.size());
+
+    // More places than the type truncates, like the vector overload.
+    auto fewer = decimal::U2::decode_binary(buf.data(), buf.size());
+    ASSERT_EQ(fewer.ec, std::errc());
+    ASSERT_EQ(fewer.value, decimal::U2("123.45"));
+
+    // Every prefix of a value is incomplete; the exact copy makes a read past it visible to sanitizers.
+    for (size_t n = 0; n < first.size; ++n) {
+        std::vector<uint8_t> prefix(buf.begin(), buf.begin() + n);
+        ASSERT_EQ(decimal::U8::decode_binary(prefix.data(), prefix.size()).ec, std::errc::invalid_argument);
+    }
+
+    std::vector<uint8_t> overlong(10, 0xFF);
+    overlong.push_back(0x01);
+    overlong.push_back(8);
+    ASSERT_EQ(decimal::U8::decode_binary(overlong.data(), overlong.size()).ec, std::errc::result_out_of_range);
+    std::vector<uint8_t> too_large{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 8};
+    ASSERT_EQ(decimal::I8::decode_binary(too_large.data(), too_large.size()).ec, std::errc::result_out_of_range);
+    std::vector<uint8_t> rescaled{0x7F, 0};
+    ASSERT_EQ(decimal::U8::decode_binary(rescaled.data(), rescaled.size()).value, decimal::U8("127"));
+    rescaled = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0};
+    ASSERT_EQ(decimal::U8::decode_binary(rescaled.data(), rescaled.size()).ec, std::errc::result_out_of_range);
+
+    decimal::U8 result;
+    offset = 0;
+    std::vector<uint8_t> truncated{0x80};
+    ASSERT_THROW(result.decode_binary(truncated, offset), std::invalid_argument);
+    ASSERT_THROW(result.decode_binary(overlong, offset), std::overflow_error);
+    ASSERT_EQ(offset, 0u);
+
+#ifdef __cpp_lib_span
+    ASSERT_EQ(decimal::U8::decode_binary(std::span<const uint8_t>(buf)).value, decimal::U8("123.456"));
+#endif
+}
+
+TEST_F(DecimalEncodeDecodeTest, EncodeBytes) {
+    ASSERT_EQ(decimal::U8::max_encoded_size, 11u);
+    ASSERT_EQ(decimal::I2::max_encoded_size, 11u);
+    ASSERT_EQ((decimal::Decimal<18, decimal::WideUnsigned>::max_encoded_size), 20u);
+
+    std::array<decimal::U8, 5> values = {decimal::U8("0"), decimal::U8("0.00000127"), decimal::U8("123.456"),
+                                         decimal::U8("99999999999.99999999"), decimal::U8("1.5")};
+    std::vector<uint8_t> expected;
+    size_t offset = 0;
+    for (const auto& v : values) {
+        std::array<uint8_t, decimal::U8::max_encoded_size> buf;
+        size_t n = v.encode_binary(buf.data());
+        ASSERT_EQ(std::vector<uint8_t>(buf.begin(), buf.begin() + n), v.encode_binary());
+        v.encode_binary(expected, offset);
+    }
+    ASSERT_EQ(offset, expected.size());
+    ASSERT_EQ(values[0].encode_binary(), (std::vector<uint8_t>{0, 8}));
+    ASSERT_EQ(values[1].encode_binary(), (std::vector<uint8_t>{0x7F, 8}));
+
+    // Encoding into the middle of a vector keeps the bytes after the value.
+    std::vector<uint8_t> filled(20, 0xAA);
+    offset = 3;
+    decimal::U8("1.5").encode_binary(filled, offset);
+    ASSERT_EQ(offset, 3u + decimal::U8("1.5").encode_binary().size());
+    ASSERT_EQ(filled.size(), 20u);
+    ASSERT_EQ(std::vector<uint8_t>(filled.begin() + offset, filled.end()), std::vector<uint8_t>(20 - offset, 0xAA));
+    ASSERT_EQ(std::vector<uint8_t>(filled.begin(), filled.begin() + 3), std::vector<uint8_t>(3, 0xAA));
+
+    std::vector<uint8_t> out(values.size() * decimal::U8::max_encoded_size);
+    size_t size = decimal::U8::encode_binary_batch(values.data(), values.data() + values.size(), out.data());
+    ASSERT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + size), expected);
+
+    const uint8_t* p = out.data();
+    for (const auto& v : values) {
+        auto res = decimal::U8::decode_binary(p, out.data() + size - p);
+        ASSERT_EQ(res.ec, std::errc());
+        ASSERT_EQ(res.value, v);
+        p += res.size;
+    }
+
+    // Wrap values may use every bit, the longest varint.
+    using WrapU8 = decimal::Decimal<8, decimal::Unsigned, decimal::Overflow::Wrap>;
+    WrapU8 top;
+    top.fp = std::numeric_limits<uint64_t>::max();
+    auto bytes = top.encode_binary();
+    ASSERT_EQ(bytes.size(), WrapU8::max_encoded_size);
+    ASSERT_EQ(WrapU8::decode_binary(bytes.data(), bytes.size()).value, top);
+
+    using WU18 = decimal::Decimal<18, decimal::WideUnsigned>;
+    WU18 wide("12345678901234567890.123456789012345678");
+    std::array<uint8_t, WU18::max_encoded_size> wide_buf;
+    size_t wide_size = wide.encode_binary(wide_buf.data());
+    ASSERT_EQ(WU18::decode_binary(wide_buf.data(), wide_size).value, wide);
+}
+
+TEST_F(DecimalEncodeDecodeTest, ZigZag) {
+    ASSERT_EQ(decimal::I2("-0.01").encode_binary(), (std::vector<uint8_t>{0x01, 0x42}));
+    ASSERT_EQ(decimal::I2("0.01").encode_binary(), (std::vector<uint8_t>{0x02, 0x42}));
+    ASSERT_EQ(decimal::I2("-1.23").encode_binary().size(), 3u);
+    ASSERT_EQ(decimal::U2("1.23").encode_binary(), (std::vector<uint8_t>{0x7B, 0x02}));
+
+    std::vector<decimal::I8> values = {decimal::I8("0"), decimal::I8("-0.00000001"), decimal::I8("-123.456"), decimal::I8("123.456"),
+                                       decimal::I8(decimal::I8::max_fp), decimal::I8(decimal::I8::min_fp)};
+    std::vector<uint8_t> buf;
+    size_t offset = 0;
+    for (const auto& v : values) {
+        v.encode_binary(buf, offset);
+    }
+    offset = 0;
+    for (const auto& v : values) {
+        decimal::I8 result;
+        result.decode_binary(buf, offset);
+        ASSERT_EQ(result, v);
+    }
+    ASSERT_EQ(offset, buf.size());
+
+    // Fewer places scale up and more truncate toward zero, whatever the sign.
+    auto bytes = decimal::I2("-1.23").encode_binary();
+    ASSERT_EQ(decimal::I8::decode_binary(bytes.data(), bytes.size()).value, decimal::I8("-1.23"));
+    bytes = decimal::I8("-1.23456789").encode_binary();
+    ASSERT_EQ(decimal::I2::decode_binary(bytes.data(), bytes.size()).value, decimal::I2("-1.23"));
+
+    // Plain varints from unsigned types still decode into signed ones, but not the reverse.
+    bytes = decimal::U8("42.5").encode_binary();
+    ASSERT_EQ(decimal::I8::decode_binary(bytes.data(), bytes.size()).value, decimal::I8("42.5"));
+    bytes = decimal::I8("42.5").encode_binary();
+    ASSERT_EQ(decimal::U8::decode_binary(bytes.data(), bytes.size()).value, decimal::U8("42.5"));
+    bytes = decimal::I8("-42.5").encode_binary();
+    ASSERT_EQ(decimal::U8::decode_binary(bytes.data(), bytes.size()).ec, std::errc::result_out_of_range);
+    bytes.back() |= 0x80;
+    ASSERT_EQ(decimal::I8::decode_binary(bytes.data(), bytes.size()).ec, std::errc::invalid_argument);
+
+    using WrapI8 = decimal::Decimal<8, decimal::Signed, decimal::Overflow::Wrap>;
+    WrapI8 low;
+    low.fp = std::numeric_limits<int64_t>::min();
+    bytes = low.encode_binary();
+    ASSERT_EQ(bytes.size(), WrapI8::max_encoded_size);
+    ASSERT_EQ(WrapI8::decode_binary(bytes.data(), bytes.size()).value, low);
+    ASSERT_EQ(decimal::I8::decode_binary(bytes.data(), bytes.size()).ec, std::errc::result_out_of_range);
+
+    using W18 = decimal::Decimal<18, decimal::WideSigned>;
+    W18 wide("-12345678901234567890.123456789012345678");
+    bytes = wide.encode_binary();
+    ASSERT_EQ(W18::decode_binary(bytes.data(), bytes.size()).value, wide);
+}
+
+TEST_F(DecimalEncodeDecodeTest, DecodeBatch) {
+    // Enough values of every length to cover both the vector path and the scalar tail.
+    std::vector<decimal::I8> values(200);
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto fp = static_cast<int64_t>((i * 0x9E3779B97F4A7C15ULL) >> (i % 63 + 1));
+        values[i].fp = std::min(fp, decimal::I8::max_fp);
+        if (i % 3 == 0) {
+            values[i] = -values[i];
+        }
+    }
+    values[7] = decimal::I8(decimal::I8::min_fp);
+    values[8] = decimal::I8(decimal::I8::max_fp);
+
+    std::vector<uint8_t> bytes(values.size() * decimal::I8::max_encoded_size);
+    bytes.resize(decimal::I8::encode_binary_batch(values.data(), values.data() + values.size(), bytes.data()));
+    std::vector<decimal::I8> out(values.size());
+    auto res = decimal::I8::decode_binary_batch(bytes.data(), bytes.size(), out.data(), out.size());
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.value, values.size());
+    ASSERT_EQ(res.size, bytes.size());
+    ASSERT_EQ(out, values);
+
+    // A clean end stops early without error; a cut value reports where it starts.
+    res = decimal::I8::decode_binary_batch(bytes.data(), bytes.size(), out.data(), 150);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.value, 150u);
+    auto cut = decimal::I8::decode_binary_batch(bytes.data(), res.size - 1, out.data(), out.size());
+    ASSERT_EQ(cut.ec, std::errc::invalid_argument);
+    ASSERT_EQ(cut.value, 149u);
+    auto ended = decimal::I8::decode_binary_batch(bytes.data(), res.size, out.data(), out.size());
+    ASSERT_EQ(ended.ec, std::errc());
+    ASSERT_EQ(ended.value, 150u);
+    ASSERT_EQ(ended.size, res.size);
+
+    // Each value keeps its own places, so mixed data still decodes.
+    std::vector<uint8_t> mixed;
+    size_t offset = 0;
+    for (int i = 0; i < 40; ++i) {
+        decimal::I2("-1.25").encode_binary(mixed, offset);
+        decimal::U8("3.5").encode_binary(mixed, offset);
+    }
+    res = decimal::I8::decode_binary_batch(mixed.data(), mixed.size(), out.data(), out.size());
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.value, 80u);
+    ASSERT_EQ(out[0], decimal::I8("-1.25"));
+    ASSERT_EQ(out[79], decimal::I8("3.5"));
+
+    // A value this type cannot hold stops the batch at that value.
+    using WrapU8 = decimal::Decimal<8, decimal::Unsigned, decimal::Overflow::Wrap>;
+    WrapU8 top;
+    top.fp = std::numeric_limits<uint64_t>::max();
+    std::vector<uint8_t> bad(mixed.begin(), mixed.begin() + 5 * 9);
+    offset = bad.size();
+    top.encode_binary(bad, offset);
+    bad.insert(bad.end(), mixed.begin(), mixed.end());
+    res = decimal::I8::decode_binary_batch(bad.data(), bad.size(), out.data(), out.size());
+    ASSERT_EQ(res.ec, std::errc::result_out_of_range);
+    ASSERT_EQ(res.value, 10u);
+    ASSERT_EQ(res.size, 5u * 9);
+
+    // The stream form writes the places once.
+    std::vector<uint8_t> stream(values.size() * decimal::I8::max_encoded_size + 1);
+    stream.resize(decimal::I8::encode_binary_stream(values.data(), values.data() + values.size(), stream.data()));
+    ASSERT_EQ(stream.size(), bytes.size() - values.size() + 1);
+    std::fill(out.begin(), out.end(), decimal::I8());
+    res = decimal::I8::decode_binary_stream(stream.data(), stream.size(), out.data(), out.size());
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.value, values.size());
+    ASSERT_EQ(res.size, stream.size());
+    ASSERT_EQ(out, values);
+    res = decimal::I8::decode_binary_stream(stream.data(), stream.size() - 1, out.data(), out.size());
+    ASSERT_EQ(res.ec, std::errc::invalid_argument);
+    ASSERT_EQ(res.value, values.size() - 1);
+
+    // Fewer places in the header scale up as for decode_binary.
+    std::array<decimal::I2, 2> cents = {decimal::I2("-1.25"), decimal::I2("3.5")};
+    std::array<uint8_t, 2 * decimal::I2::max_encoded_size + 1> cents_bytes;
+    size_t cents_size = decimal::I2::encode_binary_stream(cents.data(), cents.data() + cents.size(), cents_bytes.data());
+    res = decimal::I8::decode_binary_stream(cents_bytes.data(), cents_size, out.data(), out.size());
+    ASSERT_EQ(res.value, 2u);
+    ASSERT_EQ(out[0], decimal::I8("-1.25"));
+    ASSERT_EQ(out[1], decimal::I8("3.5"));
+
+    using W18 = decimal::Decimal<18, decimal::WideSigned>;
+    std::array<W18, 3> wide = {W18("-12345678901234567890.123456789012345678"), W18("0"), W18("1.5")};
+    std::vector<uint8_t> wide_bytes(wide.size() * W18::max_encoded_size + 1);
+    wide_bytes.resize(W18::encode_binary_stream(wide.data(), wide.data() + wide.size(), wide_bytes.data()));
+    std::array<W18, 3> wide_out;
+    ASSERT_EQ(W18::decode_binary_stream(wide_bytes.data(), wide_bytes.size(), wide_out.data(), wide_out.size()).value, 3u);
+    ASSERT_EQ(wide_out, wide);
+
+#ifdef __cpp_lib_span
+    res = decimal::I8::decode_binary_batch(std::span<const uint8_t>(bytes), std::span<decimal::I8>(out));
+    ASSERT_EQ(res.value, values.size());
+    std::vector<uint8_t> span_bytes(values.size() * decimal::I8::max_encoded_size + 1);
+    ASSERT_EQ(decimal::I8::encode_binary_stream(std::span<const decimal::I8>(values), span_bytes.data()), stream.size());
+    res = decimal::I8::decode_binary_stream(std::span<const uint8_t>(stream), std::span<decimal::I8>(out));
+    ASSERT_EQ(res.value, values.size());
+#endif
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();